@@ -0,0 +1,78 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# chmod +x bash/bench_huge_pages.sh
+# Compares dTLB misses and wall time of bin/max_flow with the arc, flow and
+# visited arrays on regular pages (off), transparent huge pages (thp) and
+# reserved huge pages (explicit), on large graphs of the bin/gengraph families.
+# TLB counters need `perf`; without it only the wall time is recorded.
+# Explicit huge pages need a reserved pool, e.g.:
+#   echo 512 | sudo tee /proc/sys/vm/nr_hugepages
+
+# ==== CONFIG ====
+GEN="bin/gengraph"
+MY_EXE="bin/max_flow"
+GRAPHS_DIR="graphs/huge_pages"
+OUTPUT_DIR="results/huge_pages"
+OUTPUT_CSV="$OUTPUT_DIR/results.csv"
+ALGORITHMS=("dinics" "bfs")
+MODES=("off" "thp" "explicit")
+REPETITIONS=3
+
+for exe in "$GEN" "$MY_EXE"; do
+    if [[ ! -x "$exe" ]]; then
+        echo "❌ Error: executable '$exe' not found, run make first." >&2
+        exit 1
+    fi
+done
+
+# ==== GRAPHS ====
+# Same families as bash/create_graphs.sh, sized so the arc arrays span many huge pages
+mkdir -p "$GRAPHS_DIR"
+generate() {
+    local file="$GRAPHS_DIR/$1.dimacs"
+    shift
+    [[ -e "$file" ]] || "$GEN" "$@" "$file"
+}
+generate square_mesh   5 400 25 1000
+generate matching      4 60000 25 1000
+generate random_2level 3 400 400 1000
+generate basic_line    6 300 300 25 1000
+
+# ==== RUN ====
+HAVE_PERF=0
+if command -v perf > /dev/null && perf stat -e dTLB-load-misses true > /dev/null 2>&1; then
+    HAVE_PERF=1
+else
+    echo "perf not available: recording wall time only"
+fi
+
+mkdir -p "$OUTPUT_DIR"
+echo "graph;algorithm;mode;repetition;max_flow;wall_ms;dtlb_loads;dtlb_load_misses" > "$OUTPUT_CSV"
+
+for graph in "$GRAPHS_DIR"/*.dimacs; do
+    base=$(basename "$graph" .dimacs)
+    for algorithm in "${ALGORITHMS[@]}"; do
+        for mode in "${MODES[@]}"; do
+            for rep in $(seq 1 "$REPETITIONS"); do
+                loads=""
+                misses=""
+                start=$(date +%s%N)
+                if [[ $HAVE_PERF == 1 ]]; then
+                    flow=$(perf stat -x ';' -o "$OUTPUT_DIR/perf.tmp" -e dTLB-loads,dTLB-load-misses \
+                           "$MY_EXE" "$algorithm" --huge-pages "$mode" < "$graph" 2> /dev/null)
+                    loads=$(awk -F';' '$3 ~ /dTLB-loads/ {print $1}' "$OUTPUT_DIR/perf.tmp")
+                    misses=$(awk -F';' '$3 ~ /dTLB-load-misses/ {print $1}' "$OUTPUT_DIR/perf.tmp")
+                else
+                    flow=$("$MY_EXE" "$algorithm" --huge-pages "$mode" < "$graph" 2> /dev/null)
+                fi
+                wall_ms=$(( ($(date +%s%N) - start) / 1000000 ))
+                echo "$base;$algorithm;$mode;$rep;$flow;$wall_ms;$loads;$misses" >> "$OUTPUT_CSV"
+            done
+            echo "✅ $base $algorithm $mode"
+        done
+    done
+done
+
+rm -f "$OUTPUT_DIR/perf.tmp"
+echo "✅ Results written to '$OUTPUT_CSV'"
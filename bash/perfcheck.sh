@@ -0,0 +1,103 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Run with: make perfcheck (or make perfcheck_baseline to rewrite the baseline)
+# Runs a fixed corpus with one small graph of each new_washington.c family through
+# every solver (bin/perf_check) and compares max flow, wall time, iterations and
+# arc inspections against the checked-in baseline, plus the strategy `max_flow auto`
+# picks (solver auto=<name>). Fails when the flow or that choice changes, or when
+# a metric grows beyond its tolerance:
+#   PERF_TIME_TOLERANCE   relative wall time increase allowed (default 0.50)
+#   PERF_TIME_SLACK_MS    increases below this many ms are noise (default 5)
+#   PERF_COUNT_TOLERANCE  relative increase of iterations/arc inspections (default 0)
+#   PERF_REPETITIONS      runs per solver, the best wall time counts (default 5)
+# Wall times depend on the machine: regenerate the baseline on the reference
+# machine with PERF_UPDATE_BASELINE=1 after an intentional change.
+
+# ==== CONFIG ====
+MY_EXE="bin/perf_check"
+OUTPUT_DIR="results/perfcheck"
+BASELINE_CSV="$OUTPUT_DIR/baseline.csv"
+CURRENT_CSV="$OUTPUT_DIR/current.csv"
+TIME_TOLERANCE="${PERF_TIME_TOLERANCE:-0.50}"
+TIME_SLACK_MS="${PERF_TIME_SLACK_MS:-5}"
+COUNT_TOLERANCE="${PERF_COUNT_TOLERANCE:-0}"
+REPETITIONS="${PERF_REPETITIONS:-5}"
+
+if [[ ! -x "$MY_EXE" ]]; then
+    echo "❌ Error: executable '$MY_EXE' not found, run make first." >&2
+    exit 1
+fi
+
+# ==== CORPUS ====
+# One graph per family, built in memory by bin/perf_check with the same random
+# stream as gengraph, so every machine runs the same graphs
+CORPUS=(
+    "mesh               1 20 20 1000"
+    "random_level       2 20 20 1000"
+    "random_2level      12 20 20 1000"
+    "matching           4 500 10 1000"
+    "square_mesh        5 20 10 1000"
+    "basic_line         6 15 15 4 1000"
+    "exponential_line   7 15 15 4 1000"
+    "dexponential_line  8 15 15 4 1000"
+    "dinic_bad_case     9 100"
+    "gold_bad_case      10 100"
+    "cheryian           11 20 5 5 1000"
+)
+
+# ==== RUN ====
+mkdir -p "$OUTPUT_DIR"
+echo "graph;solver;max_flow;wall_ms;iterations;arc_inspections" > "$CURRENT_CSV"
+for entry in "${CORPUS[@]}"; do
+    read -r base family <<< "$entry"
+    "$MY_EXE" "$REPETITIONS" $family | sed -e "s/^/${base};/" >> "$CURRENT_CSV"
+done
+
+if [[ "${PERF_UPDATE_BASELINE:-0}" == 1 ]]; then
+    cp "$CURRENT_CSV" "$BASELINE_CSV"
+    echo "✅ Baseline written to '$BASELINE_CSV'"
+    exit 0
+fi
+
+if [[ ! -e "$BASELINE_CSV" ]]; then
+    echo "❌ Error: baseline '$BASELINE_CSV' not found, run make perfcheck_baseline." >&2
+    exit 1
+fi
+
+# ==== COMPARE ====
+awk -F';' -v time_tol="$TIME_TOLERANCE" -v slack="$TIME_SLACK_MS" -v count_tol="$COUNT_TOLERANCE" '
+    FNR == 1 { next }
+    NR == FNR { key = $1 ";" $2; flow[key] = $3; wall[key] = $4; iters[key] = $5; arcs[key] = $6; next }
+    {
+        key = $1 ";" $2
+        seen[key] = 1
+        if (!(key in flow)) {
+            printf "⚠️  %-40s not in baseline\n", key
+            next
+        }
+        if ($3 != flow[key]) {
+            printf "❌ %-40s max flow %s, baseline %s\n", key, $3, flow[key]; failed = 1
+        }
+        if ($4 > wall[key] * (1 + time_tol) && $4 - wall[key] > slack) {
+            printf "❌ %-40s wall time %.3f ms, baseline %.3f ms (+%.0f%%)\n", key, $4, wall[key], 100 * ($4 / wall[key] - 1); failed = 1
+        }
+        if ($5 > iters[key] * (1 + count_tol)) {
+            printf "❌ %-40s iterations %s, baseline %s\n", key, $5, iters[key]; failed = 1
+        }
+        if ($6 > arcs[key] * (1 + count_tol)) {
+            printf "❌ %-40s arc inspections %s, baseline %s\n", key, $6, arcs[key]; failed = 1
+        }
+    }
+    END {
+        for (key in flow) {
+            if (!(key in seen)) { printf "❌ %-40s missing from this run\n", key; failed = 1 }
+        }
+        exit failed
+    }
+' "$BASELINE_CSV" "$CURRENT_CSV" || {
+    echo "❌ Performance regression against '$BASELINE_CSV' (results in '$CURRENT_CSV')" >&2
+    exit 1
+}
+
+echo "✅ No regression against '$BASELINE_CSV' (time +$(awk -v t="$TIME_TOLERANCE" 'BEGIN { print 100 * t }')%, counters +$(awk -v t="$COUNT_TOLERANCE" 'BEGIN { print 100 * t }')%)"
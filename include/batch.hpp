@@ -0,0 +1,22 @@
+#pragma once
+
+#include "graph.hpp"
+#include "max_flow_solver.hpp"
+#include <istream>
+#include <ostream>
+#include <vector>
+
+struct STQuery {
+    int s;
+    int t;
+};
+
+// Reads one "s t" pair per line (1-based ids up to n, 'c' lines are comments)
+std::vector<STQuery> read_queries(std::istream& in, int n);
+
+// Solves every query on a pool of workers sharing the read-only graph. Each worker
+// owns a FlowState and resets it in place between queries. Results are streamed in query
+// order as "<s> <t> <max flow>" lines as soon as all earlier queries are done.
+template <typename Cap>
+void solve_batch(const BasicGraph<Cap>& graph, const std::vector<STQuery>& queries,
+                 const BasicMaxFlowSolver<Cap>& solve, int workers, std::ostream& out);
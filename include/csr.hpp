@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+// Binary CSR graph file, written by bin/gengraph_parallel and read by Graph::read_csr
+// (max_flow recognizes it on stdin by the magic). All fields are in host byte order:
+//   Header
+//   first arc of each vertex   (n + 1) x uint64   (the last entry is m)
+//   head of each arc            m x uint32        (arcs grouped by tail, in vertex order)
+//   capacity of each arc        m x int32
+// 64-bit offsets let the generator write files with billions of arcs; a Graph still
+// needs the vertex and arc counts to fit its 32-bit indices.
+namespace csr {
+    constexpr char magic[8] = {'M', 'F', 'C', 'S', 'R', '0', '0', '1'};
+
+    struct Header {
+        char magic[8];
+        uint64_t n;        // Vertices
+        uint64_t m;        // Arcs
+        uint64_t source;
+        uint64_t sink;
+    };
+    static_assert(sizeof(Header) == 40, "the header layout is part of the file format");
+
+    inline uint64_t offsets_position() {
+        return sizeof(Header);
+    }
+    inline uint64_t heads_position(const Header& header) {
+        return offsets_position() + (header.n + 1) * sizeof(uint64_t);
+    }
+    inline uint64_t capacities_position(const Header& header) {
+        return heads_position(header) + header.m * sizeof(uint32_t);
+    }
+} // namespace csr
@@ -1,6 +1,33 @@
 #pragma once
 
 #include "graph.hpp"
+#include "flow_state.hpp"
+#include <atomic>
+#include <vector>
 
-// Returns the max flow from source to sink using Dinic's algorithm
-int dinic_max_flow(Graph& graph, int source, int sink);
\ No newline at end of file
+// Work counters of one dinic_max_flow call
+struct DinicStats {
+    long long phases = 0;          // Blocking flows, one per distance labelling that reached s
+    long long arc_inspections = 0; // Current-arc advances of the blocking-flow DFS
+};
+
+// Returns the max flow from source to sink using Dinic's algorithm, augmenting `flow` in place.
+// Each phase labels vertices with their exact distance to the sink (reverse BFS), so the
+// blocking-flow DFS only follows arcs on shortest s-t paths.
+// If source_side is given it receives the residual s side of a minimum cut.
+// If `cancel` becomes true the solver stops after the current augmenting path.
+// If stats is given the counters of this call are added to it.
+template <typename Cap>
+Cap dinic_max_flow(const BasicGraph<Cap>& graph, BasicFlowState<Cap>& flow, int source, int sink, std::vector<char>* source_side = nullptr,
+                   const std::atomic<bool>* cancel = nullptr, DinicStats* stats = nullptr);
+
+// Building blocks of a phase, exposed for the micro-benchmarks (src/tests/micro_bench.cpp).
+// bfs_level labels distances from s, bfs_dist_to_sink distances to t (both stop at the
+// layer of the other terminal); dfs_flow pushes one augmenting path along arcs with
+// dist[v] = dist[u] - 1, advancing the current-arc pointers in ptr.
+template <typename Cap>
+bool bfs_level(const BasicGraph<Cap>& graph, const BasicFlowState<Cap>& flow, std::vector<int>& level, int s, int t);
+template <typename Cap>
+bool bfs_dist_to_sink(const BasicGraph<Cap>& graph, const BasicFlowState<Cap>& flow, std::vector<int>& dist, int s, int t);
+template <typename Cap>
+Cap dfs_flow(const BasicGraph<Cap>& graph, BasicFlowState<Cap>& flow, std::vector<int>& dist, std::vector<int>& ptr, int u, int t, Cap pushed);
\ No newline at end of file
@@ -11,4 +11,5 @@ using Path = std::vector<std::pair<int, int>>;
 // Finds an s-t augmenting path using capacity scaling DFS.
 // Only explores edges with residual capacity >= current delta threshold.
 // Compatible with Ford-Fulkerson signature.
-bool capacity_scaling_path(const Graph& graph, int s, int t, Path& path, FFStats* stats);
+template <typename Cap>
+bool capacity_scaling_path(const BasicGraph<Cap>& graph, const BasicFlowState<Cap>& flow, int s, int t, Path& path, FFStats* stats);
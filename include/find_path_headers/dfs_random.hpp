@@ -10,4 +10,9 @@ using Path = std::vector<std::pair<int, int>>;
 
 // Performs a randomized DFS from source to sink in the residual graph.
 // Returns true if an s-t path is found and stores it in `path`.
-bool dfs_path(const Graph& graph, int source, int sink, Path& path, FFStats* stats);
+template <typename Cap>
+bool dfs_path(const BasicGraph<Cap>& graph, const BasicFlowState<Cap>& flow, int source, int sink, Path& path, FFStats* stats);
+
+// Reseeds the calling thread's RNG so the search order, and with it the iteration
+// count, is reproducible (bin/perf_check). Seeded from std::random_device by default.
+void dfs_random_seed(unsigned seed);
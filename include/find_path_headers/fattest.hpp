@@ -11,4 +11,5 @@ using Path = std::vector<std::pair<int, int>>;
  * Finds an s-t path maximizing the bottleneck (minimum residual capacity along the path).
  * Returns true if such a path is found in the residual graph, false otherwise.
  */
-bool fattest_path(const Graph& graph, int s, int t, Path& path, FFStats* stats);
+template <typename Cap>
+bool fattest_path(const BasicGraph<Cap>& graph, const BasicFlowState<Cap>& flow, int s, int t, Path& path, FFStats* stats);
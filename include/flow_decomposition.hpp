@@ -0,0 +1,24 @@
+#pragma once
+
+#include "graph.hpp"
+#include "flow_state.hpp"
+#include <functional>
+#include <ostream>
+
+// Receives one component of the decomposition. `vertices` points into a buffer that is
+// reused for the next component: a path goes s ... t, a cycle starts and ends at the same vertex.
+template <typename Cap>
+using BasicFlowComponentVisitor = std::function<void(bool is_cycle, Cap flow, const int* vertices, int count)>;
+using FlowComponentVisitor = BasicFlowComponentVisitor<int>;
+
+// Decomposes `flow` into at most m s-t paths and cycles, in O(nm) using current-arc
+// pointers. The flow state is not modified. Returns the number of components.
+template <typename Cap>
+int decompose_flow(const BasicGraph<Cap>& graph, const BasicFlowState<Cap>& flow, int s, int t, const BasicFlowComponentVisitor<Cap>& visit);
+
+// Streams the decomposition, one component per line (1-based vertex ids):
+//   path <flow> <s> ... <t>
+//   cycle <flow> <v> ... <v>
+// Super terminals are stripped, so a path runs from one input source to one input sink.
+template <typename Cap>
+int write_flow_decomposition(const BasicGraph<Cap>& graph, const BasicFlowState<Cap>& flow, int s, int t, std::ostream& out);
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "graph.hpp"
+#include "numa.hpp"
+#include <algorithm>
+#include <vector>
+
+// Flow of every arc of a Graph, kept apart from the topology and capacities.
+// Indexed by Edge::arc, so many FlowStates (threads, strategies, s-t pairs,
+// repetitions) can share a single read-only Graph.
+template <typename Cap>
+class BasicFlowState {
+public:
+    using Edge = BasicEdge<Cap>;
+    using Graph = BasicGraph<Cap>;
+
+    BasicFlowState() = default;
+    explicit BasicFlowState(const Graph& graph);           // All flows zero
+
+    void fit(const Graph& graph);                          // Makes room for arcs added since, with zero flow
+    void reset();                                          // Zeroes every flow in place
+
+    // Current flow through e
+    Cap flow(const Edge& e) const {
+        return flows[e.arc];
+    }
+
+    // Residual capacity = capacity - flow
+    Cap remaining_capacity(const Edge& e) const {
+        return e.capacity - flows[e.arc];
+    }
+
+    // Increases flow on e and decreases the reverse edge flow
+    void augment(const Edge& e, const Edge& reverse_edge, Cap bottleneck) {
+        flows[e.arc] += bottleneck;
+        flows[reverse_edge.arc] -= bottleneck;
+    }
+
+    Cap flow_value(const Graph& graph, int s) const;       // Net flow leaving node s
+    void print_residual_graph(const Graph& graph) const;
+
+    // Same flows with another capacity type (values must fit)
+    template <typename Other>
+    BasicFlowState<Other> convert() const {
+        BasicFlowState<Other> result;
+        numa::allocate_interleaved(result.flows, flows.size());
+        std::copy(flows.begin(), flows.end(), result.flows.begin());
+        return result;
+    }
+
+private:
+    template <typename Other> friend class BasicFlowState;
+
+    std::vector<Cap, huge_pages::Allocator<Cap>> flows;
+};
+
+using FlowState = BasicFlowState<int>;
+using FlowState64 = BasicFlowState<long long>;
+
+extern template class BasicFlowState<int>;
+extern template class BasicFlowState<long long>;
@@ -1,5 +1,7 @@
 #pragma once
 #include "graph.hpp"
+#include "flow_state.hpp"
+#include <atomic>
 #include <functional>
 #include <vector>
 
@@ -19,10 +21,9 @@ struct FFStats {
 
     // === Critical metrics, specific of Edmons-Karp (BFS)===
     int m_residual = 0.0;                   // number of residual edges, will be initialized after read the graph
-    std::vector<int> criticalCount;        // counter C for each edge
+    std::vector<int> criticalCount;        // counter C for each arc pair, at the even Edge::arc of the pair
     double cFrac = 0.0;                    // fraction of edges that were critical at least once (C)
     double rBar = 0.0;                     // average criticality among critical edges (r̄)
-    int offset = 0;                        // auxiliar to calculate offset because we have negative ids (backward edges) and positive ids (forward edges)
 
     // === Time metrics ===
     double total_runtime = 0.0; // Total execution time in seconds (T(n, m))
@@ -60,14 +61,24 @@ struct FFStats {
 
 	// === Aux for capacity scaling ===
 	bool max_cap_initialized = false;
-	int delta;
-	int max_cap;
+	long long delta;
+	long long max_cap;
 };
 
 
-// Type for a path-finding strategy function
-using PathFindingStrategy = std::function<bool(const Graph&, int s, int t, Path& path, FFStats* stats)>;
+// Type for a path-finding strategy function (searches the residual graph of `flow`)
+template <typename Cap>
+using BasicPathFindingStrategy = std::function<bool(const BasicGraph<Cap>&, const BasicFlowState<Cap>& flow, int s, int t, Path& path, FFStats* stats)>;
+using PathFindingStrategy = BasicPathFindingStrategy<int>;
 
-// Runs Ford-Fulkerson algorithm using a given strategy.
+// Pushes the bottleneck of `path` (from a path-finding strategy) and counts the arcs
+// it saturates in stats->criticalCount (sized by ford_fulkerson). Returns the bottleneck.
+template <typename Cap>
+Cap augment(const BasicGraph<Cap>& graph, BasicFlowState<Cap>& flow, const Path& path, FFStats* stats);
+
+// Runs Ford-Fulkerson algorithm using a given strategy, augmenting `flow` in place.
 // Returns the maximum flow value and optionally stores flow path stats.
-int ford_fulkerson(Graph& graph, int s, int t, PathFindingStrategy find_path, AlgorithmType type, FFStats* stats);
+// If `cancel` becomes true the search stops before the next path and the flow found so far is returned.
+template <typename Cap>
+Cap ford_fulkerson(const BasicGraph<Cap>& graph, BasicFlowState<Cap>& flow, int s, int t, BasicPathFindingStrategy<Cap> find_path,
+                   AlgorithmType type, FFStats* stats, const std::atomic<bool>* cancel = nullptr);
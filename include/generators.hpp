@@ -0,0 +1,46 @@
+#pragma once
+
+#include "graph.hpp"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// The instance families of new_washington.c (bin/gengraph), built directly as a Graph
+// in memory, so benchmarks can sweep sizes without writing and re-parsing DIMACS files.
+// The random stream reproduces glibc random(), which gengraph seeds with 1: with the
+// default seed every family gives the same graph as reading the gengraph file.
+// Vertex 0 is the source and the last vertex the sink, as in gengraph.
+namespace generators {
+    // glibc random() (additive feedback, degree 31) with its own state
+    class Random {
+    public:
+        explicit Random(unsigned seed = 1);
+
+        int32_t next();                                     // Uniform in [0, 2^31)
+        int32_t integer(int32_t low, int32_t high);         // RandomInteger of new_washington.c
+        void subset(int32_t low, int32_t high, int count, int32_t* x); // `count` distinct values in [low, high]
+
+    private:
+        std::array<uint32_t, 31> state;
+        int front = 3, rear = 0;
+    };
+
+    // gengraph 1..11, with its argument order
+    Graph mesh(int rows, int cols, int range, unsigned seed = 1);
+    Graph random_level(int rows, int cols, int range, unsigned seed = 1);
+    Graph random_2level(int rows, int cols, int range, unsigned seed = 1);
+    Graph matching(int n, int degree, int range, unsigned seed = 1);
+    Graph square_mesh(int side, int degree, int range, unsigned seed = 1);
+    Graph basic_line(int n, int m, int degree, int range, unsigned seed = 1);
+    Graph exponential_line(int n, int m, int degree, int range, unsigned seed = 1);
+    Graph double_exponential_line(int n, int m, int degree, int range, unsigned seed = 1);
+    Graph dinic_bad_case(int n);
+    Graph gold_bad_case(int n);
+    Graph cheryian(int n, int m, int c, int very_big = 1000000);
+
+    // Family by its gengraph number and parameters (without the output file), e.g.
+    // generate(5, {20, 10, 1000}) is `gengraph 5 20 10 1000`. Type 3 builds a random
+    // leveled graph, as gengraph does; type 12, which gengraph lacks, is random_2level
+    // (the R2Level function of new_washington.c) with the parameters of type 3.
+    Graph generate(int type, const std::vector<int>& params, unsigned seed = 1);
+} // namespace generators
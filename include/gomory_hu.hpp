@@ -0,0 +1,30 @@
+#pragma once
+
+#include "graph.hpp"
+#include "max_flow_solver.hpp"
+#include <ostream>
+#include <vector>
+
+// Gomory-Hu tree (Gusfield's construction): the min-cut value between any two
+// vertices is the smallest weight on the tree path between them.
+template <typename Cap>
+struct BasicGomoryHuTree {
+    std::vector<int> parent;   // Parent in the tree, -1 for the root (vertex 0)
+    std::vector<Cap> weight;   // Min-cut value between v and parent[v]
+
+    Cap min_cut(int u, int v) const;
+};
+
+using GomoryHuTree = BasicGomoryHuTree<int>;
+using GomoryHuTree64 = BasicGomoryHuTree<long long>;
+
+// Builds the tree of the undirected version of `graph` (see Graph::make_undirected)
+// with n-1 max-flow computations. All workers share one undirected copy of the graph;
+// each owns a FlowState and resets it in place between computations. Flows are computed speculatively
+// with the current parent and redone in the rare case an earlier cut changed it.
+template <typename Cap>
+BasicGomoryHuTree<Cap> gomory_hu_tree(const BasicGraph<Cap>& graph, const BasicMaxFlowSolver<Cap>& solve, int workers);
+
+// Writes the tree as "p ghtree <n>" followed by "e <v> <parent> <min cut>" lines (1-based)
+template <typename Cap>
+void write_gomory_hu_tree(const BasicGomoryHuTree<Cap>& tree, std::ostream& out);
@@ -1,74 +1,189 @@
 #pragma once
 
+#include "huge_pages.hpp"
 #include <vector>
 #include <iostream>
 #include <string>
+#include <limits>
 
-// Represents a directed edge with a reverse edge in the residual graph
-struct Edge {
-    int id;       // Unique ID (forward >=0, reverse = -1)
+template <typename Cap> class BasicFlowState;
+
+// Represents a directed edge with a reverse edge in the residual graph.
+// Only topology and capacity live here; the flow is kept in a FlowState
+// (see flow_state.hpp), so one Graph can be shared by many concurrent solves.
+// Cap is the capacity (and flow) type: int, or long long when sums may overflow.
+// The tail is the vertex whose list holds the edge, so it is not stored: with int
+// capacities an edge takes 16 bytes.
+template <typename Cap>
+struct BasicEdge {
     int to;       // Destination node
-    int from;     // Source node (for debugging and utilities)
     int rev;      // Index of reverse edge in the destination's adjacency list
-    int capacity; // Max capacity of the edge
-    int flow;     // Current flow through this edge
+    int arc;      // Slot of this edge in a FlowState (even for the forward half of a pair)
+    Cap capacity; // Max capacity of the edge
+
+    // True for the half a pair was created from (u -> v of add_edge/add_arc),
+    // so loops over all arcs can handle each pair once
+    bool is_forward() const {
+        return (arc & 1) == 0;
+    }
 
     // True if this edge is a residual edge (no capacity)
     bool is_residual() const {
         return capacity == 0;
     }
 
-    // Residual capacity = capacity - flow
-    int remaining_capacity() const {
-        return capacity - flow;
-    }
-
-    // Increases flow and decreases the reverse edge flow
-    void augment(int bottleneck, Edge& reverse_edge) {
-        flow += bottleneck;
-        reverse_edge.flow -= bottleneck;
-    }
-
-    // Debug helper to show edge information
-    std::string to_string(int s = -1, int t = -1) const {
+    // Debug helper to show edge information; `from` is the list it was taken from
+    std::string to_string(int from, int s = -1, int t = -1) const {
         std::string u = (from == s ? "s" : (from == t ? "t" : std::to_string(from)));
         std::string v = (to   == s ? "s" : (to   == t ? "t" : std::to_string(to)));
         return "Edge " + u + " -> " + v +
-               " | flow = " + std::to_string(flow) +
                " | capacity = " + std::to_string(capacity) +
                " | is residual: " + (is_residual() ? "true" : "false");
     }
 };
 
-class Graph {
+static_assert(sizeof(BasicEdge<int>) == 16, "int edges are meant to stay at 16 bytes");
+
+// The arcs of one vertex: a contiguous run inside the graph's arc block
+template <typename Edge>
+class EdgeRange {
+public:
+    EdgeRange(const Edge* first, int count) : first(first), count(count) {}
+
+    const Edge* begin() const { return first; }
+    const Edge* end() const { return first + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const Edge& operator[](size_t i) const { return first[i]; }
+
+private:
+    const Edge* first;
+    int count;
+};
+
+template <typename Cap>
+class BasicGraph {
 public:
-    Graph(int n = 0); // Initialize a graph with n nodes
+    using Edge = BasicEdge<Cap>;
+    using FlowState = BasicFlowState<Cap>;
 
-    void add_edge(int from, int to, int capacity);         // Adds forward and reverse edge
+    BasicGraph(int n = 0); // Initialize a graph with n nodes
+
+    // Copy with another capacity type (see fits_in)
+    template <typename Other>
+    explicit BasicGraph(const BasicGraph<Other>& other);
+
+    // Construction is two-pass: add_edge only records the arc, and compress_graph
+    // counts the degrees and lays every list out in one block, merging parallel
+    // and antiparallel arcs into forward/reverse pairs.
+    void add_edge(int from, int to, Cap capacity);         // Records an input arc (not visible before compress_graph)
+    void reserve_edges(size_t m);                          // Room for m add_edge calls
     void read_dimacs(std::istream& in);                    // Load graph in DIMACS format
+    void read_csr(std::istream& in);                       // Load graph in binary CSR format (see csr.hpp)
     void compress_graph();
-    void print_residual_graph() const;
+    void make_undirected();                                // Each arc u -> v of capacity c becomes an edge {u, v} of capacity c
+    void sort_arc_lists();                                 // Orders each adjacency list by neighbour id (FlowState slots are kept)
 
     // Basic accessors
     int size() const;                                      // Number of vertices
     int num_vertices() const;                              // Alias for size()
     int num_edges() const;                                 // Number of forward edges (original)
     int num_edges_residual() const;                        // Number of forward edges (residual)
-    int get_min_edge_id() const;
-    int total_out_capacity(int s) const;                   // Sum of capacities out of node s
+    Cap total_out_capacity(int s) const;                   // Sum of capacities out of node s
+    Cap max_incident_capacity() const;                     // Largest sum of capacities in and out of a node
+    int num_arc_slots() const;                             // Size of a FlowState for this graph
+
+    // In-place capacity edits (used to warm-start solvers from the current flow).
+    // Flow states keep their values; repair_flow fixes the ones that became infeasible.
+    int find_arc(int u, int v) const;                      // Index of arc u -> v in adj(u), or -1
+    void set_capacity(int u, int v, Cap capacity);         // Changes capacity of arc u -> v
+    const std::vector<std::pair<int, int>>& lowered_arcs() const; // Arcs (u, v) whose capacity went down
+    void clear_lowered_arcs();
+
+    // Topology edits after compress_graph (the merged antiparallel pairs are kept).
+    // New arcs get new FlowState slots (see FlowState::fit); erased arcs leave theirs unused.
+    void add_arc(int u, int v, Cap capacity);              // Adds capacity to u -> v, creating the pair if needed
+    void remove_arc(int u, int v);                         // Drops the u -> v capacity, the pair is erased once unused
+    void purge_removed_arcs(const FlowState& state);       // Erases removed pairs that carry no flow in `state`
 
-    const std::vector<Edge>& adj(int u) const;             // Read-only access to adjacents
-    std::vector<std::vector<Edge>>& get_adj();             // Writable adjacency list
-    const std::vector<Edge>& get_neighbors(int u) const;   // Alias to adj()
+    EdgeRange<Edge> adj(int u) const;                      // Read-only access to adjacents
+    EdgeRange<Edge> get_neighbors(int u) const;            // Alias to adj()
 
     int get_source() const;                                // Source node index
     int get_sink() const;                                  // Sink node index
 
+    // Terminal sets. With more than one source (sink) a super source (sink) is
+    // appended in place after the input vertices and becomes get_source() (get_sink()).
+    // Its arc to each terminal holds the terminal's total capacity, and grows when
+    // set_capacity or add_arc raise that total, so it never limits the flow.
+    void set_terminals(const std::vector<int>& sources, const std::vector<int>& sinks);
+    const std::vector<int>& get_sources() const;
+    const std::vector<int>& get_sinks() const;
+    int num_input_vertices() const;                        // Vertices of the input, without super terminals
+
 private:
+    template <typename Other> friend class BasicGraph;
+
     int n;                                                 // Number of nodes
+    int input_n;                                           // Number of nodes before super terminals were added
     int source = -1, sink = -1;                            // Source/sink indices (initialized to -1)
-    int next_edge_id = 0;
-    int next_edge_id_reverse = 0;
-    int next_edge_id_aux = 0;
-    std::vector<std::vector<Edge>> adj_list;               // Adjacency list
+    int next_arc = 0;                                      // Next free FlowState slot (always even)
+    std::vector<int> sources, sinks;                       // Terminal sets as given in the input
+    // Arc lists of all vertices, back to back in one block. Lists grown by add_arc
+    // move to the end of the block with room to spare; the hole they leave stays
+    // until the next compress_graph. Large blocks may use huge pages (see huge_pages.hpp)
+    // and are interleaved over the NUMA nodes when that is enabled (see numa.hpp).
+    struct ArcList {
+        size_t first = 0;                                  // Position of the list in `arcs`
+        int degree = 0;                                    // Arcs in the list
+        int room = 0;                                      // Slots reserved for it
+    };
+    struct InputArc {
+        int from;
+        int to;
+        Cap capacity;
+    };
+    std::vector<Edge, huge_pages::Allocator<Edge>> arcs;
+    std::vector<ArcList, huge_pages::Allocator<ArcList>> lists;
+    std::vector<InputArc> pending;                         // Arcs of add_edge waiting for compress_graph
+    std::vector<std::pair<int, int>> lowered;              // Arcs whose capacity was lowered by set_capacity
+    std::vector<std::pair<int, int>> removed;              // Pairs waiting for their flow to be drained
+
+    void check_vertex(int u) const;
+    Edge* list(int u);
+    void push_arc(int u, const Edge& e);
+    void append_pair(int u, int v, Cap capacity);
+    int add_super_terminal(const std::vector<int>& terminals, bool is_source);
+    void grow_super_arcs(int u, int v);
+    bool erase_unused_pair(int u, int v, const FlowState& state);
 };
+
+using Edge = BasicEdge<int>;
+using Graph = BasicGraph<int>;
+using Edge64 = BasicEdge<long long>;
+using Graph64 = BasicGraph<long long>;
+
+extern template class BasicGraph<int>;
+extern template class BasicGraph<long long>;
+extern template BasicGraph<int>::BasicGraph(const BasicGraph<long long>&);
+extern template BasicGraph<long long>::BasicGraph(const BasicGraph<int>&);
+
+// True if every flow of `graph`, including the undirected capacities used by
+// Gomory-Hu trees, stays within Cap: no node has more capacity around it than that
+template <typename Cap, typename Other>
+bool fits_in(const BasicGraph<Other>& graph) {
+    return graph.max_incident_capacity() <= static_cast<Other>(std::numeric_limits<Cap>::max());
+}
+
+// A graph read with the narrowest capacity type that holds all its flows: `graph`
+// unless some vertex has more than 2^31-1 of capacity around it (see fits_in), then
+// `wide`. Arcs are recorded as int while reading and only converted when that limit
+// is crossed, so an int graph is built directly, never through a 64-bit copy.
+struct InputGraph {
+    Graph graph;
+    Graph64 wide;
+    bool is_wide = false;
+};
+
+// Reads DIMACS text or a binary CSR file (see csr.hpp), told apart by the magic
+InputGraph read_graph(std::istream& in);
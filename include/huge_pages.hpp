@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace huge_pages {
+    // How the large arrays (graph arcs, flows, visited marks) are backed
+    enum class Mode {
+        Default,     // Whatever the kernel does by default
+        Off,         // Regular 4 KB pages (MADV_NOHUGEPAGE)
+        Transparent, // Transparent huge pages (MADV_HUGEPAGE)
+        Explicit     // Reserved huge pages (MAP_HUGETLB), transparent ones if the pool is empty
+    };
+
+    // Mode of the arrays allocated from now on. Set once before loading the graph.
+    void set_mode(Mode mode);
+    Mode mode();
+
+    // Parses "off", "thp" or "explicit"; throws for anything else
+    Mode parse_mode(const std::string& name);
+
+    inline constexpr size_t page_size = size_t(2) << 20;
+
+    // Blocks of at least one huge page are mapped directly, 2 MB aligned and sized
+    // in whole huge pages, so the kernel can back them with huge pages; smaller
+    // ones (and every block outside Linux) come from operator new.
+    void* allocate(size_t bytes);
+    void deallocate(void* p, size_t bytes);
+
+    // Allocator for std::vector over the functions above
+    template <typename T>
+    struct Allocator {
+        using value_type = T;
+
+        Allocator() = default;
+        template <typename U>
+        Allocator(const Allocator<U>&) {}
+
+        T* allocate(size_t n) {
+            return static_cast<T*>(huge_pages::allocate(n * sizeof(T)));
+        }
+        void deallocate(T* p, size_t n) {
+            huge_pages::deallocate(p, n * sizeof(T));
+        }
+    };
+
+    template <typename T, typename U>
+    bool operator==(const Allocator<T>&, const Allocator<U>&) { return true; }
+    template <typename T, typename U>
+    bool operator!=(const Allocator<T>&, const Allocator<U>&) { return false; }
+} // namespace huge_pages
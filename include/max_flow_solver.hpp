@@ -0,0 +1,18 @@
+#pragma once
+
+#include "graph.hpp"
+#include "flow_state.hpp"
+#include <atomic>
+#include <functional>
+#include <string>
+
+// Any max-flow solver augmenting `flow` in place on a shared read-only graph
+template <typename Cap>
+using BasicMaxFlowSolver = std::function<Cap(const BasicGraph<Cap>& graph, BasicFlowState<Cap>& flow, int s, int t)>;
+using MaxFlowSolver = BasicMaxFlowSolver<int>;
+
+// Solver for one of the strategy names accepted by main (bfs, dfs, fat, scaling, dinics).
+// The solver gives up (returning the flow found so far) once `cancel` becomes true.
+// Returns an empty function for an unknown name.
+template <typename Cap = int>
+BasicMaxFlowSolver<Cap> make_solver(const std::string& name, const std::atomic<bool>* cancel = nullptr);
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "graph.hpp"
+#include "flow_state.hpp"
+#include <vector>
+#include <utility>
+#include <ostream>
+
+// Minimum s-t cut read off a maximum flow
+template <typename Cap>
+struct BasicMinCut {
+    std::vector<char> source_side;           // 1 if the vertex is on the s side of the cut
+    std::vector<std::pair<int, int>> arcs;   // Cut arcs as (from_node, index of edge in graph[from_node])
+    Cap capacity = 0;                        // Sum of capacities of the cut arcs (= max flow)
+};
+
+using MinCut = BasicMinCut<int>;
+using MinCut64 = BasicMinCut<long long>;
+
+// Vertices reachable from s in the residual graph (1 = reachable), nothing else
+template <typename Cap>
+std::vector<char> residual_source_side(const BasicGraph<Cap>& graph, const BasicFlowState<Cap>& flow, int s);
+
+// Labels the vertices reachable from s in the final residual graph of any solver
+// and collects the saturated arcs leaving that set.
+template <typename Cap>
+BasicMinCut<Cap> min_cut(const BasicGraph<Cap>& graph, const BasicFlowState<Cap>& flow, int s);
+
+// Same, for solvers that already know the source side (e.g. Dinic's last level graph).
+// All sources of a terminal set end up on the s side and all sinks on the t side.
+template <typename Cap>
+BasicMinCut<Cap> min_cut_from_side(const BasicGraph<Cap>& graph, std::vector<char> source_side);
+
+// Writes the cut in a DIMACS-like format (1-based vertex ids):
+//   p cut <capacity> <source side size> <number of cut arcs>
+//   n <v> s          one line per source-side vertex
+//   a <u> <v> <cap>  one line per cut arc
+template <typename Cap>
+void write_cut(const BasicGraph<Cap>& graph, const BasicMinCut<Cap>& cut, std::ostream& out);
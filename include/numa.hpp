@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+
+namespace numa {
+    // Spreads the graph over all NUMA nodes and pins pool workers round-robin to
+    // the nodes, so parallel searches and batch workers draw on every socket's
+    // memory bandwidth. Set once before loading the graph; off by default.
+    void set_interleave(bool enabled);
+    bool interleave_enabled();
+
+    int num_nodes();                           // Online NUMA nodes (1 without NUMA support)
+
+    // Interleaves the pages fully inside [p, p + bytes) over all nodes. Only pages
+    // not yet touched are placed, so call it between allocating and filling an array.
+    // No-op when disabled, on a single node, outside Linux, or on a thread pinned by
+    // pin_worker: what a pinned worker allocates is its own and stays on its node.
+    void interleave(void* p, size_t bytes);
+
+    // Pins the calling thread to the CPUs of node worker % num_nodes() (no-op when disabled)
+    void pin_worker(int worker);
+
+    // Gives `v` exactly `count` value-initialized elements (its old contents are
+    // dropped), spreading the pages over the nodes before initialization touches them
+    template <typename Vector>
+    void allocate_interleaved(Vector& v, size_t count) {
+        Vector().swap(v);
+        v.reserve(count);
+        interleave(v.data(), count * sizeof(typename Vector::value_type));
+        v.resize(count);
+    }
+} // namespace numa
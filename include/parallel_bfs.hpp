@@ -0,0 +1,43 @@
+#pragma once
+
+#include "graph.hpp"
+#include "flow_state.hpp"
+#include <utility>
+#include <vector>
+
+namespace parallel_bfs {
+    // Threads used by bfs_level and bfs_path on large graphs (1 = sequential).
+    // Set once before solving; callers that already run solves in parallel
+    // (batch, Gomory-Hu, portfolio) keep it at 1.
+    void set_workers(int workers);
+    int workers();
+
+    // Smallest number of residual arcs for which the parallel search pays off
+    inline constexpr int min_parallel_arcs = 1 << 18;
+
+    // Direction switching thresholds (Beamer et al.), shared with the sequential bfs_level:
+    // go bottom-up once the frontier arcs exceed the unexplored arcs / alpha, and back
+    // top-down once the frontier has fewer than n / beta vertices
+    inline constexpr int alpha = 14;
+    inline constexpr int beta = 24;
+
+    // Work done by one search, as counted in FFStats
+    struct Counters {
+        long long visited_nodes = 0;
+        long long forward_arcs = 0;
+        long long residual_arcs = 0;
+    };
+
+    // Level-synchronous BFS over arcs with residual capacity, each frontier shared
+    // by `workers` threads. Switches between top-down steps (frontier vertices scan
+    // their arcs) and bottom-up steps (unvisited vertices look for a frontier
+    // predecessor through their reverse arcs) depending on the frontier size.
+    // Stops after the layer that contains t. Fills level (-1 = not reached) and,
+    // if given, parent[v] = (u, index of u -> v in adj(u)). Returns true if t was reached.
+    // With `reverse` the search follows residual arcs backwards, so level[v] becomes the
+    // distance from v to s (call it with s = sink to get distance-to-sink labels).
+    template <typename Cap>
+    bool search(const BasicGraph<Cap>& graph, const BasicFlowState<Cap>& flow, int s, int t, int workers,
+                std::vector<int>& level, std::vector<std::pair<int, int>>* parent = nullptr,
+                Counters* counters = nullptr, bool reverse = false);
+} // namespace parallel_bfs
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "csr.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Parallel generator for very large mesh, random leveled and matching graphs
+// (gengraph families 1, 2 and 4, same parameters), written straight to a CSR file.
+// Every vertex's arc count is known in closed form, so each worker takes blocks of
+// vertices and writes their offsets, heads and capacities at their final place in
+// the file, keeping only one block in memory. Random draws come from a counter-based
+// generator: draw k of vertex u is a hash of (seed, u, k), so the file is the same
+// for any number of workers. The streams differ from gengraph's, so these are other
+// instances of the same families (see generators.hpp for gengraph's exact graphs).
+namespace parallel_generator {
+    // Counter-based random stream of one vertex (SplitMix64 mixing of seed, vertex, draw)
+    class VertexRandom {
+    public:
+        VertexRandom(uint64_t seed, uint64_t vertex);
+
+        uint64_t next();
+        int32_t integer(int32_t low, int32_t high);          // Uniform in [low, high]
+        void subset(int64_t low, int64_t high, int count, int64_t* x); // `count` distinct values in [low, high]
+
+    private:
+        uint64_t key;
+        uint64_t counter = 0;
+    };
+
+    struct Family {
+        int type;                  // 1 mesh (rows, cols, range), 2 random level (rows, cols, range),
+        std::vector<int64_t> params; // 4 matching (n, degree, range)
+    };
+
+    // Checks the parameters and returns the header of the graph the family describes
+    csr::Header describe(const Family& family);
+
+    // Writes the graph to `path`, with `workers` threads (0 uses all hardware threads)
+    csr::Header write_csr(const Family& family, uint64_t seed, int workers, const std::string& path);
+} // namespace parallel_generator
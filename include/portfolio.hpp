@@ -0,0 +1,25 @@
+#pragma once
+
+#include "graph.hpp"
+#include "flow_state.hpp"
+#include <string>
+#include <vector>
+
+// Strategies raced by default
+inline const std::vector<std::string> default_portfolio = {"bfs", "dfs", "fat", "scaling", "dinics"};
+
+template <typename Cap>
+struct BasicPortfolioResult {
+    Cap max_flow = 0;
+    std::string winner;         // Strategy that finished first
+    BasicFlowState<Cap> flow;   // Its final flow (for cuts and path decompositions)
+};
+
+using PortfolioResult = BasicPortfolioResult<int>;
+
+// Runs every strategy on its own thread and private FlowState over the shared graph.
+// The first one to finish wins; the others are cancelled cooperatively and their
+// partial flows are dropped.
+template <typename Cap>
+BasicPortfolioResult<Cap> solve_portfolio(const BasicGraph<Cap>& graph, int s, int t,
+                                          const std::vector<std::string>& strategies = default_portfolio);
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "graph.hpp"
+#include "flow_state.hpp"
+#include <vector>
+
+// The part of a graph that can carry s-t flow, renumbered compactly
+template <typename Cap>
+struct BasicPrunedGraph {
+    BasicGraph<Cap> graph;      // Source and sink already set
+    std::vector<int> original;  // Vertex of the input graph for each vertex of `graph`
+};
+
+using PrunedGraph = BasicPrunedGraph<int>;
+
+// Keeps the vertices reachable from s that can also reach t (over arcs with capacity)
+// and the arcs between them, dropping arcs into s and out of t, which only carry cycles.
+// Returns false, leaving `pruned` untouched, if nothing would be removed.
+template <typename Cap>
+bool prune_graph(const BasicGraph<Cap>& graph, BasicPrunedGraph<Cap>& pruned);
+
+// Copies a flow of the pruned graph onto the arcs of the input graph; arcs that were
+// pruned get no flow, so cuts and path decompositions can use the input graph directly.
+template <typename Cap>
+void map_flow_back(const BasicGraph<Cap>& graph, const BasicPrunedGraph<Cap>& pruned, const BasicFlowState<Cap>& pruned_flow,
+                   BasicFlowState<Cap>& flow);
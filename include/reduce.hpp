@@ -0,0 +1,47 @@
+#pragma once
+
+#include "graph.hpp"
+#include "flow_state.hpp"
+#include <utility>
+#include <vector>
+
+// Arc of the reduction, between vertices of the graph being reduced
+template <typename Cap>
+struct BasicReducedArc {
+    int from;
+    int to;
+    Cap capacity;
+};
+
+// One contraction, undone in reverse order when the flow is mapped back
+struct Reduction {
+    bool is_series;  // series: `arc` replaced parts[0] -> parts[1]; parallel: `arc` merged both parts
+    int arc;
+    int parts[2];
+};
+
+// A graph after series/parallel contraction, with what is needed to map a flow back
+template <typename Cap>
+struct BasicReducedGraph {
+    BasicGraph<Cap> graph;                      // Source and sink already set
+    std::vector<int> original;                  // Vertex of the input graph for each vertex of `graph`
+    std::vector<BasicReducedArc<Cap>> arcs;     // Input arcs first, then the ones created by contractions
+    std::vector<std::pair<int, int>> input_arc; // (u, index in adj(u)) of each input arc
+    std::vector<int> live;                      // Arcs left in `graph`
+    std::vector<Reduction> steps;               // In the order they were applied
+};
+
+using ReducedGraph = BasicReducedGraph<int>;
+
+// Repeats until fixpoint: a vertex (other than s and t) with a single incoming and
+// a single outgoing arc is replaced by one arc of the minimum capacity, parallel
+// arcs are merged by adding their capacities, and vertices without incoming or
+// outgoing arcs are dropped. Returns false, leaving `reduced` untouched, if
+// nothing could be contracted.
+template <typename Cap>
+bool reduce_graph(const BasicGraph<Cap>& graph, BasicReducedGraph<Cap>& reduced);
+
+// Copies a flow of the reduced graph onto the arcs of the input graph
+template <typename Cap>
+void map_flow_back(const BasicGraph<Cap>& graph, const BasicReducedGraph<Cap>& reduced, const BasicFlowState<Cap>& reduced_flow,
+                   BasicFlowState<Cap>& flow);
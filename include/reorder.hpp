@@ -0,0 +1,21 @@
+#pragma once
+
+#include "graph.hpp"
+#include "prune.hpp"
+#include <string>
+
+// Vertex orderings for reorder_graph
+enum class VertexOrder {
+    BFS, // Breadth-first from s, so each layer of the level graph is contiguous
+    RCM  // Reverse Cuthill-McKee, which keeps the bandwidth of the adjacency matrix small
+};
+
+// Parses "bfs" or "rcm"; throws for anything else
+VertexOrder parse_vertex_order(const std::string& name);
+
+// Relabels the vertices so that neighbours get close ids and rebuilds the adjacency
+// lists sorted by neighbour id, making arc scans walk memory mostly forward.
+// Nothing is dropped, so the result has the shape of a pruned graph and
+// map_flow_back (prune.hpp) maps its flows back to the input ids.
+template <typename Cap>
+BasicPrunedGraph<Cap> reorder_graph(const BasicGraph<Cap>& graph, VertexOrder order);
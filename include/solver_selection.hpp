@@ -0,0 +1,29 @@
+#pragma once
+
+#include "graph.hpp"
+#include "portfolio.hpp"
+#include <string>
+#include <vector>
+
+// Cheap structural features of an instance, computed in O(n + m) right after loading
+struct InstanceFeatures {
+    int n = 0;                  // Vertices
+    int m = 0;                  // Arcs with positive capacity
+    double avg_out_degree = 0.0;
+    int st_depth = -1;          // Arcs on a shortest s-t path, -1 if t is unreachable
+    int max_level_width = 0;    // Largest BFS layer in front of t
+};
+
+template <typename Cap>
+InstanceFeatures compute_features(const BasicGraph<Cap>& graph, int s, int t);
+
+// Picks the candidate expected to run fastest. Strategies are ranked per regime,
+// calibrated on bin/perf_check timings over the gengraph families:
+// - dinics wins on the layered, mesh, matching and line families;
+// - capacity scaling wins, by three orders of magnitude, on thin graphs whose t is
+//   close to s while most of the graph lies beyond it (dinic_bad_case): the flow
+//   uses paths of every length, and Dinic needs a phase for each;
+// - without dinics, random DFS wins on shallow and wide (matching-like) instances
+//   and capacity scaling on the deep layered ones.
+std::string select_strategy(const InstanceFeatures& features,
+                            const std::vector<std::string>& candidates = default_portfolio);
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <functional>
+#include <thread>
+
+namespace thread_pool {
+    // Number of workers to use when the caller does not say (at least one)
+    inline int default_workers() {
+        unsigned hw = std::thread::hardware_concurrency();
+        return hw > 0 ? static_cast<int>(hw) : 1;
+    }
+
+    // Runs body(worker_id) on `workers` threads and waits for all of them.
+    // Workers are expected to pull their own tasks (e.g. from an atomic counter).
+    // The threads are started on first use and parked between calls, so callers that
+    // run once per BFS or Dinic phase do not pay thread creation each time. With NUMA
+    // interleaving on, worker w is pinned to a node when it starts (see numa.hpp).
+    // Calls made while the pool is busy (from a worker, or from another thread) get
+    // threads of their own.
+    void run(int workers, const std::function<void(int)>& body);
+} // namespace thread_pool
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "graph.hpp"
+#include "ford_fulkerson.hpp"
+
+// Restores a feasible s-t flow after Graph::set_capacity lowered capacities below
+// the flow held in `flow`. The excess of each overloaded arc is first rerouted around it,
+// and whatever cannot be rerouted is sent back to s (and pulled back from t).
+// Pairs dropped with Graph::remove_arc are erased once their flow is gone.
+// Only this flow state is repaired; other states of the same graph must be refit or reset.
+// Returns the value of the repaired flow.
+template <typename Cap>
+Cap repair_flow(BasicGraph<Cap>& graph, BasicFlowState<Cap>& flow, int s, int t);
+
+// Repairs the current flow and keeps augmenting from it instead of starting from zero,
+// so arcs added with Graph::add_arc or edited with set_capacity/remove_arc only cost
+// the augmentations they enable.
+// Returns the maximum flow value of the edited network.
+template <typename Cap>
+Cap warm_ford_fulkerson(BasicGraph<Cap>& graph, BasicFlowState<Cap>& flow, int s, int t, BasicPathFindingStrategy<Cap> find_path, AlgorithmType type, FFStats* stats);
+template <typename Cap>
+Cap warm_dinic_max_flow(BasicGraph<Cap>& graph, BasicFlowState<Cap>& flow, int s, int t);
@@ -0,0 +1,68 @@
+#include "batch.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+std::vector<STQuery> read_queries(std::istream& in, int n) {
+    std::vector<STQuery> queries;
+    std::string line;
+
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == 'c') continue; // Skip comments
+
+        std::istringstream iss(line);
+        int s, t;
+        if (!(iss >> s >> t)) {
+            throw std::runtime_error("Invalid query line: " + line);
+        }
+        if (s < 1 || s > n || t < 1 || t > n || s == t) {
+            throw std::runtime_error("Invalid query pair: " + line);
+        }
+        queries.push_back({s - 1, t - 1});
+    }
+
+    return queries;
+}
+
+template <typename Cap>
+void solve_batch(const BasicGraph<Cap>& graph, const std::vector<STQuery>& queries,
+                 const BasicMaxFlowSolver<Cap>& solve, int workers, std::ostream& out) {
+    int q = queries.size();
+    if (q == 0) return;
+
+    std::vector<Cap> result(q);
+    std::vector<char> done(q, 0);
+    int next_to_print = 0;
+    std::mutex mtx;
+    std::atomic<int> next_query{0};
+
+    workers = std::max(1, std::min(workers, q));
+
+    thread_pool::run(workers, [&](int) {
+        BasicFlowState<Cap> state(graph); // private flows for this worker, reused for every query
+
+        for (int i = next_query++; i < q; i = next_query++) {
+            state.reset();
+            Cap flow = solve(graph, state, queries[i].s, queries[i].t);
+
+            // Print the longest finished prefix
+            std::lock_guard<std::mutex> lock(mtx);
+            result[i] = flow;
+            done[i] = 1;
+            while (next_to_print < q && done[next_to_print]) {
+                const STQuery& query = queries[next_to_print];
+                out << query.s + 1 << " " << query.t + 1 << " " << result[next_to_print] << "\n";
+                ++next_to_print;
+            }
+        }
+    });
+
+    out.flush();
+}
+
+template void solve_batch(const Graph&, const std::vector<STQuery>&, const MaxFlowSolver&, int, std::ostream&);
+template void solve_batch(const Graph64&, const std::vector<STQuery>&, const BasicMaxFlowSolver<long long>&, int, std::ostream&);
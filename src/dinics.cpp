@@ -1,52 +1,115 @@
 #include "dinics.hpp"
+#include "parallel_bfs.hpp"
 #include <vector>
-#include <queue>
 #include <algorithm>
+#include <limits>
+
+// Layered BFS from `from` until the layer containing `to`, over residual arcs
+// (followed backwards when `reverse` is set). Fills label with the distances.
+template <typename Cap>
+static bool layered_bfs(const BasicGraph<Cap>& graph, const BasicFlowState<Cap>& flow, std::vector<int>& label, int from, int to, bool reverse) {
+    using Edge = BasicEdge<Cap>;
+    // Large graphs: level-synchronous search shared by several threads
+    if (parallel_bfs::workers() > 1 && graph.num_arc_slots() >= parallel_bfs::min_parallel_arcs) {
+        return parallel_bfs::search(graph, flow, from, to, parallel_bfs::workers(), label, nullptr, nullptr, reverse);
+    }
+
+    // Residual capacity from x to e.to (resp. from e.to to x) for an arc e of adj(x)
+    auto residual = [&](const Edge& e) {
+        return reverse ? flow.remaining_capacity(graph.adj(e.to)[e.rev]) : flow.remaining_capacity(e);
+    };
+    auto residual_in = [&](const Edge& e) {
+        return reverse ? flow.remaining_capacity(e) : flow.remaining_capacity(graph.adj(e.to)[e.rev]);
+    };
 
-// Builds level graph using BFS from source
-bool bfs_level(const Graph& graph, std::vector<int>& level, int s, int t) {
     int n = graph.size();
-    level.assign(n, -1);
-    level[s] = 0;
+    label.assign(n, -1);
+    label[from] = 0;
 
-    std::queue<int> q;
-    q.push(s);
+    // Direction-optimizing BFS, one layer at a time. Top-down steps scan the arcs
+    // of the frontier; once the frontier is large, bottom-up steps let each unvisited
+    // vertex look for a frontier neighbour and stop at the first one, skipping most
+    // arcs of the middle layers.
+    std::vector<int> frontier = {from};
+    std::vector<int> next;
+    long long unexplored = graph.num_edges_residual() - static_cast<long long>(graph.adj(from).size());
+    bool bottom_up = false;
 
-    while (!q.empty()) {
-        int u = q.front(); q.pop();
+    for (int depth = 0; !frontier.empty() && label[to] == -1; ++depth) {
+        next.clear();
 
-        for (const Edge& e : graph.get_neighbors(u)) {
-            // Only consider forward edges with remaining capacity
-            if (e.capacity - e.flow > 0 && level[e.to] == -1) {
-                level[e.to] = level[u] + 1;
-                q.push(e.to);
+        if (!bottom_up) {
+            for (int u : frontier) {
+                for (const Edge& e : graph.get_neighbors(u)) {
+                    if (label[e.to] == -1 && residual(e) > 0) {
+                        label[e.to] = depth + 1;
+                        next.push_back(e.to);
+                    }
+                }
+            }
+        } else {
+            for (int v = 0; v < n; ++v) {
+                if (label[v] != -1) continue;
+                for (const Edge& e : graph.get_neighbors(v)) {
+                    if (label[e.to] == depth && residual_in(e) > 0) {
+                        label[v] = depth + 1;
+                        next.push_back(v);
+                        break;
+                    }
+                }
             }
         }
+
+        frontier.swap(next);
+
+        long long frontier_arcs = 0;
+        for (int u : frontier) frontier_arcs += graph.adj(u).size();
+        unexplored -= frontier_arcs;
+
+        if (!bottom_up && frontier_arcs > unexplored / parallel_bfs::alpha) {
+            bottom_up = true;
+        } else if (bottom_up && static_cast<long long>(frontier.size()) * parallel_bfs::beta < n) {
+            bottom_up = false;
+        }
     }
 
-    // If sink is unreachable, return false
-    return level[t] != -1;
+    return label[to] != -1;
 }
 
-// DFS to send flow through level graph
-int dfs_flow(Graph& graph, std::vector<int>& level, std::vector<int>& ptr, int u, int t, int pushed) {
+// Builds level graph using BFS from source
+template <typename Cap>
+bool bfs_level(const BasicGraph<Cap>& graph, const BasicFlowState<Cap>& flow, std::vector<int>& level, int s, int t) {
+    return layered_bfs(graph, flow, level, s, t, false);
+}
+
+// Exact distance-to-sink labels, from a reverse BFS that stops at the layer of s.
+// Vertices that cannot reach t, or only through a longer path, get -1 or a label
+// that no admissible arc leads to, so the DFS never enters them.
+template <typename Cap>
+bool bfs_dist_to_sink(const BasicGraph<Cap>& graph, const BasicFlowState<Cap>& flow, std::vector<int>& dist, int s, int t) {
+    return layered_bfs(graph, flow, dist, t, s, true);
+}
+
+// DFS to send flow along admissible arcs (dist[v] = dist[u] - 1), all on shortest s-t paths
+template <typename Cap>
+Cap dfs_flow(const BasicGraph<Cap>& graph, BasicFlowState<Cap>& flow, std::vector<int>& dist, std::vector<int>& ptr, int u, int t, Cap pushed) {
+    using Edge = BasicEdge<Cap>;
     if (pushed == 0) return 0;
     if (u == t) return pushed;
 
-    auto& adj = graph.get_adj();
+    const auto& adj = graph.adj(u);
 
     // Try all edges starting from ptr[u]
-    for (int& cid = ptr[u]; cid < (int)adj[u].size(); ++cid) {
-        Edge& e = adj[u][cid];
-        // Follow only valid level edges with capacity
-        if (level[e.to] != level[u] + 1 || e.capacity - e.flow <= 0) continue;
+    for (int& cid = ptr[u]; cid < (int)adj.size(); ++cid) {
+        const Edge& e = adj[cid];
+        // Follow only admissible edges with capacity
+        if (dist[e.to] + 1 != dist[u] || flow.remaining_capacity(e) <= 0) continue;
 
-        int tr = dfs_flow(graph, level, ptr, e.to, t, std::min(pushed, e.capacity - e.flow));
+        Cap tr = dfs_flow(graph, flow, dist, ptr, e.to, t, std::min(pushed, flow.remaining_capacity(e)));
         if (tr == 0) continue;
 
         // Push flow and update reverse edge
-        e.flow += tr;
-        adj[e.to][e.rev].flow -= tr;
+        flow.augment(e, graph.adj(e.to)[e.rev], tr);
         return tr;
     }
 
@@ -54,19 +117,51 @@ int dfs_flow(Graph& graph, std::vector<int>& level, std::vector<int>& ptr, int u
 }
 
 // Computes max flow using Dinic's algorithm
-int dinic_max_flow(Graph& graph, int s, int t) {
-    int flow = 0;
-    std::vector<int> level;
+template <typename Cap>
+Cap dinic_max_flow(const BasicGraph<Cap>& graph, BasicFlowState<Cap>& flow, int s, int t, std::vector<char>* source_side,
+                   const std::atomic<bool>* cancel, DinicStats* stats) {
+    Cap total = 0;
+    std::vector<int> dist;
     std::vector<int> ptr;
 
-    // Rebuild level graph and find blocking flow repeatedly
-    while (bfs_level(graph, level, s, t)) {
+    flow.fit(graph); // arcs may have been added since the flow state was created
+
+    auto cancelled = [cancel] { return cancel && cancel->load(std::memory_order_relaxed); };
+
+    // Relabel from the sink and find blocking flow repeatedly
+    while (!cancelled() && bfs_dist_to_sink(graph, flow, dist, s, t)) {
         ptr.assign(graph.size(), 0);
+        if (stats) ++stats->phases;
 
-        while (int pushed = dfs_flow(graph, level, ptr, s, t, 1e9)) {
-            flow += pushed;
+        bool stopped = false;
+        while (Cap pushed = dfs_flow(graph, flow, dist, ptr, s, t, std::numeric_limits<Cap>::max())) {
+            total += pushed;
+            if ((stopped = cancelled())) break;
         }
+        if (stats) {
+            for (int advanced : ptr) stats->arc_inspections += advanced;
+        }
+        if (stopped) return total;
     }
 
-    return flow;
+    // The residual s side, from one forward BFS (t is unreachable, so it explores all of it)
+    if (source_side) {
+        std::vector<int> level;
+        bfs_level(graph, flow, level, s, t);
+        source_side->assign(graph.size(), 0);
+        for (int v = 0; v < graph.size(); ++v) {
+            (*source_side)[v] = (level[v] != -1);
+        }
+    }
+
+    return total;
 }
+
+template bool bfs_level(const Graph&, const FlowState&, std::vector<int>&, int, int);
+template bool bfs_level(const Graph64&, const FlowState64&, std::vector<int>&, int, int);
+template bool bfs_dist_to_sink(const Graph&, const FlowState&, std::vector<int>&, int, int);
+template bool bfs_dist_to_sink(const Graph64&, const FlowState64&, std::vector<int>&, int, int);
+template int dfs_flow(const Graph&, FlowState&, std::vector<int>&, std::vector<int>&, int, int, int);
+template long long dfs_flow(const Graph64&, FlowState64&, std::vector<int>&, std::vector<int>&, int, int, long long);
+template int dinic_max_flow(const Graph&, FlowState&, int, int, std::vector<char>*, const std::atomic<bool>*, DinicStats*);
+template long long dinic_max_flow(const Graph64&, FlowState64&, int, int, std::vector<char>*, const std::atomic<bool>*, DinicStats*);
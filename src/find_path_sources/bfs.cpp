@@ -1,8 +1,44 @@
 #include "find_path_headers/bfs.hpp"
+#include "parallel_bfs.hpp"
 #include <queue>
 #include <algorithm>
 
-bool bfs_path(const Graph& graph, int s, int t, Path& path, FFStats* stats) {
+// Walks the parent links back from t, giving the path from s to t
+static void build_path(const std::vector<std::pair<int, int>>& parent, int s, int t, Path& path) {
+    path.clear();
+    for (int u = t; u != s; u = parent[u].first) {
+        int prev = parent[u].first;
+        int idx = parent[u].second;
+        path.push_back({prev, idx});
+    }
+
+    std::reverse(path.begin(), path.end()); // Ensure path goes from s to t
+}
+
+// Same search on several threads, for large graphs
+template <typename Cap>
+static bool parallel_bfs_path(const BasicGraph<Cap>& graph, const BasicFlowState<Cap>& flow, int s, int t, Path& path, FFStats* stats) {
+    std::vector<int> level;
+    std::vector<std::pair<int, int>> parent;
+    parallel_bfs::Counters counters;
+    bool found = parallel_bfs::search(graph, flow, s, t, parallel_bfs::workers(), level, &parent, &counters);
+
+    stats->visited_nodes_per_iter.push_back(static_cast<int>(counters.visited_nodes));
+    stats->visited_forward_arcs_per_iter.push_back(static_cast<int>(counters.forward_arcs));
+    stats->visited_residual_arcs_per_iter.push_back(static_cast<int>(counters.residual_arcs));
+
+    if (!found) return false;
+    build_path(parent, s, t, path);
+    return true;
+}
+
+template <typename Cap>
+bool bfs_path(const BasicGraph<Cap>& graph, const BasicFlowState<Cap>& flow, int s, int t, Path& path, FFStats* stats) {
+    using Edge = BasicEdge<Cap>;
+    if (parallel_bfs::workers() > 1 && graph.num_arc_slots() >= parallel_bfs::min_parallel_arcs) {
+        return parallel_bfs_path(graph, flow, s, t, path, stats);
+    }
+
     int n = graph.size();
     bfs_state::reset(n);  // Prepare visited array and increment token
 
@@ -39,7 +75,7 @@ bool bfs_path(const Graph& graph, int s, int t, Path& path, FFStats* stats) {
             ++visited_arcs_residual;
 
             // Skip visited nodes or saturated edges
-            if (bfs_state::visited[e.to] != bfs_state::visitedToken && e.capacity > e.flow) {
+            if (bfs_state::visited[e.to] != bfs_state::visitedToken && flow.remaining_capacity(e) > 0) {
                 bfs_state::visited[e.to] = bfs_state::visitedToken;
                 parent[e.to] = {u, static_cast<int>(i)};
                 q.push(e.to);
@@ -64,14 +100,10 @@ bool bfs_path(const Graph& graph, int s, int t, Path& path, FFStats* stats) {
     }
 
     // Reconstruct path from t to s using parent info
-    path.clear();
-    for (int u = t; u != s; u = parent[u].first) {
-        int prev = parent[u].first;
-        int idx = parent[u].second;
-        path.push_back({prev, idx});
-    }
-
-    std::reverse(path.begin(), path.end()); // Ensure path goes from s to t
+    build_path(parent, s, t, path);
 
     return true;
 }
+
+template bool bfs_path(const Graph&, const FlowState&, int, int, Path&, FFStats*);
+template bool bfs_path(const Graph64&, const FlowState64&, int, int, Path&, FFStats*);
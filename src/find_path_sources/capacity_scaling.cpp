@@ -6,8 +6,8 @@
 #include <cmath>
 
 namespace {
-    std::vector<uint64_t> visited;
-    uint64_t visitedToken = 1;
+    thread_local std::vector<uint64_t> visited;
+    thread_local uint64_t visitedToken = 1;
 
     void reset(size_t n) {
         if (visited.size() < n) visited.assign(n, 0);
@@ -15,7 +15,9 @@ namespace {
     }
 }
 
-static bool dfs_with_delta(const Graph& graph, int s, int t, Path& path, int delta, FFStats* stats) {
+template <typename Cap>
+static bool dfs_with_delta(const BasicGraph<Cap>& graph, const BasicFlowState<Cap>& flow, int s, int t, Path& path, Cap delta, FFStats* stats) {
+    using Edge = BasicEdge<Cap>;
     int n = graph.size();
     std::vector<std::pair<int, int>> parent(n, {-1, -1});
     std::stack<int> st;
@@ -34,7 +36,7 @@ static bool dfs_with_delta(const Graph& graph, int s, int t, Path& path, int del
         const auto& neighbors = graph.get_neighbors(u);
         for (size_t i = 0; i < neighbors.size() && !found; ++i) {
             const Edge& e = neighbors[i];
-            int residual = e.remaining_capacity();
+            Cap residual = flow.remaining_capacity(e);
             if (residual >= delta) {
                 if (e.capacity > 0) {
                     ++visited_arcs_forward;
@@ -71,19 +73,21 @@ static bool dfs_with_delta(const Graph& graph, int s, int t, Path& path, int del
     return true;
 }
 
-bool capacity_scaling_path(const Graph& graph, int s, int t, Path& path, FFStats* stats) {
+template <typename Cap>
+bool capacity_scaling_path(const BasicGraph<Cap>& graph, const BasicFlowState<Cap>& flow, int s, int t, Path& path, FFStats* stats) {
+    using Edge = BasicEdge<Cap>;
     // Initialize max capacity and delta only once
     if (!stats->max_cap_initialized) {
         stats->max_cap = 0;
         for (int u = 0; u < graph.size(); ++u) {
             for (const Edge& e : graph.get_neighbors(u)) {
-                stats->max_cap = std::max(stats->max_cap, e.remaining_capacity());
+                stats->max_cap = std::max<long long>(stats->max_cap, flow.remaining_capacity(e));
             }
         }
         
         // Calculate initial delta as the highest power of 2 <= max_cap
         if (stats->max_cap > 0) {
-            stats->delta = 1 << (31 - __builtin_clz(stats->max_cap));
+            stats->delta = 1LL << (63 - __builtin_clzll(stats->max_cap));
         } else {
             stats->delta = 0;
         }
@@ -97,7 +101,7 @@ bool capacity_scaling_path(const Graph& graph, int s, int t, Path& path, FFStats
     // Textbook approach: No early exit based on max_cap
     while (stats->delta > 0) {
         reset(graph.size());
-        if (dfs_with_delta(graph, s, t, path, stats->delta, stats)) {
+        if (dfs_with_delta(graph, flow, s, t, path, static_cast<Cap>(stats->delta), stats)) {
             // Key change: Skip max_cap recomputation entirely
             return true;
         }
@@ -105,4 +109,7 @@ bool capacity_scaling_path(const Graph& graph, int s, int t, Path& path, FFStats
         stats->delta >>= 1;
     }
     return false;
-}
\ No newline at end of file
+}
+
+template bool capacity_scaling_path(const Graph&, const FlowState&, int, int, Path&, FFStats*);
+template bool capacity_scaling_path(const Graph64&, const FlowState64&, int, int, Path&, FFStats*);
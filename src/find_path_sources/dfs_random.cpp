@@ -5,10 +5,16 @@
 #include <random>
 #include <stack>
 
-// Static RNG for better performance (avoids frequent re-seeding)
-static std::mt19937 rng(std::random_device{}());
+// Static RNG for better performance (avoids frequent re-seeding), one per thread
+static thread_local std::mt19937 rng(std::random_device{}());
 
-bool dfs_path(const Graph& graph, int source, int sink, Path& path, FFStats* stats) {
+void dfs_random_seed(unsigned seed) {
+    rng.seed(seed);
+}
+
+template <typename Cap>
+bool dfs_path(const BasicGraph<Cap>& graph, const BasicFlowState<Cap>& flow, int source, int sink, Path& path, FFStats* stats) {
+    using Edge = BasicEdge<Cap>;
     const int n = graph.size();
     bfs_state::reset(n);
 
@@ -40,7 +46,7 @@ bool dfs_path(const Graph& graph, int source, int sink, Path& path, FFStats* sta
     
         for (const int i : order) {
             const Edge& e = neighbors[i];
-            const int residual = e.capacity - e.flow;
+            const Cap residual = flow.remaining_capacity(e);
 
             if (residual > 0) {  // More efficient than method call
                 visited_arcs_residual++;
@@ -74,4 +80,7 @@ bool dfs_path(const Graph& graph, int source, int sink, Path& path, FFStats* sta
     stats->visited_forward_arcs_per_iter.push_back(visited_arcs_forward);
     stats->visited_residual_arcs_per_iter.push_back(visited_arcs_residual);
     return false;
-}
\ No newline at end of file
+}
+
+template bool dfs_path(const Graph&, const FlowState&, int, int, Path&, FFStats*);
+template bool dfs_path(const Graph64&, const FlowState64&, int, int, Path&, FFStats*);
@@ -6,19 +6,22 @@
 #include <algorithm>
 
 // Used in priority queue: stores node and its bottleneck capacity so far
+template <typename Cap>
 struct State {
-    int cap;
+    Cap cap;
     int node;
     bool operator<(const State& other) const {
         return cap < other.cap; // max-heap by bottleneck
     }
 };
 
-bool fattest_path(const Graph& graph, int s, int t, Path& path, FFStats* stats) {
+template <typename Cap>
+bool fattest_path(const BasicGraph<Cap>& graph, const BasicFlowState<Cap>& flow, int s, int t, Path& path, FFStats* stats) {
+    using Edge = BasicEdge<Cap>;
     int n = graph.size();
     bfs_state::reset(n);  // reset visited array using visitedToken trick
 
-    std::vector<int> max_cap(n, 0); // max bottleneck capacity to each node
+    std::vector<Cap> max_cap(n, 0); // max bottleneck capacity to each node
     std::vector<std::pair<int, int>> parent(n, {-1, -1}); // (prev_node, edge_index)
 
     int real_inserts = 0;
@@ -29,14 +32,14 @@ bool fattest_path(const Graph& graph, int s, int t, Path& path, FFStats* stats)
     int visited_arcs_forward =0;
 
 
-    std::priority_queue<State> pq;
-    pq.push({std::numeric_limits<int>::max(), s});
-    max_cap[s] = std::numeric_limits<int>::max();
+    std::priority_queue<State<Cap>> pq;
+    pq.push({std::numeric_limits<Cap>::max(), s});
+    max_cap[s] = std::numeric_limits<Cap>::max();
     ++total_inserts;
     ++real_inserts;
 
     while (!pq.empty()) {
-        State state = pq.top();
+        State<Cap> state = pq.top();
         pq.pop();
         int u = state.node;
         ++deleteMins;
@@ -66,10 +69,10 @@ bool fattest_path(const Graph& graph, int s, int t, Path& path, FFStats* stats)
 
             ++visited_arcs_residual;
 
-            int residual = e.remaining_capacity();
+            Cap residual = flow.remaining_capacity(e);
             if (residual <= 0) continue;
 
-            int cap = std::min(max_cap[u], residual);
+            Cap cap = std::min(max_cap[u], residual);
             if (cap > max_cap[e.to] && bfs_state::visited[e.to] != bfs_state::visitedToken) {
 				if (max_cap[e.to] == 0) { 
 					++real_inserts; // First time seeing this node
@@ -108,3 +111,6 @@ bool fattest_path(const Graph& graph, int s, int t, Path& path, FFStats* stats)
 
     return true;
 }
+
+template bool fattest_path(const Graph&, const FlowState&, int, int, Path&, FFStats*);
+template bool fattest_path(const Graph64&, const FlowState64&, int, int, Path&, FFStats*);
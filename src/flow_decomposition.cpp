@@ -0,0 +1,113 @@
+#include "flow_decomposition.hpp"
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+template <typename Cap>
+int decompose_flow(const BasicGraph<Cap>& graph, const BasicFlowState<Cap>& flow, int s, int t, const BasicFlowComponentVisitor<Cap>& visit) {
+    int n = graph.size();
+
+    // Flat copy of the positive flows, so the flow state itself stays untouched
+    std::vector<int> first(n + 1, 0);
+    for (int u = 0; u < n; ++u) {
+        first[u + 1] = first[u] + static_cast<int>(graph.adj(u).size());
+    }
+    std::vector<Cap> remaining(first[n]);
+    for (int u = 0; u < n; ++u) {
+        const auto& neighbors = graph.adj(u);
+        for (size_t i = 0; i < neighbors.size(); ++i) {
+            remaining[first[u] + i] = std::max<Cap>(0, flow.flow(neighbors[i]));
+        }
+    }
+
+    std::vector<int> ptr(first.begin(), first.end() - 1); // current arc of each vertex
+    std::vector<int> stack_v(n + 1);                      // vertices of the current walk
+    std::vector<int> stack_a(n + 1);                      // arc leaving stack_v[i]
+    std::vector<int> pos(n, -1);                          // position of a vertex in the walk
+    int top = -1;
+    int components = 0;
+
+    auto head = [&](int a, int u) { return graph.adj(u)[a - first[u]].to; };
+
+    // Subtracts the bottleneck of the arcs stack_a[from..top] and reports the component
+    auto emit = [&](int from, bool is_cycle) {
+        Cap amount = std::numeric_limits<Cap>::max();
+        for (int i = from; i < top + is_cycle; ++i) amount = std::min(amount, remaining[stack_a[i]]);
+        for (int i = from; i < top + is_cycle; ++i) remaining[stack_a[i]] -= amount;
+
+        if (is_cycle) stack_v[top + 1] = stack_v[from];
+        visit(is_cycle, amount, stack_v.data() + from, top - from + 1 + is_cycle);
+        ++components;
+    };
+
+    auto pop_to = [&](int new_top) {
+        while (top > new_top) pos[stack_v[top--]] = -1;
+    };
+
+    // Follows positive-flow arcs from `start`, emitting s-t paths (when stop_at_t)
+    // and every cycle closed on the way, until `start` has no outgoing flow left.
+    auto walk = [&](int start, bool stop_at_t) {
+        stack_v[0] = start;
+        pos[start] = 0;
+        top = 0;
+
+        while (top >= 0) {
+            int u = stack_v[top];
+
+            if (stop_at_t && u == t) {
+                emit(0, false);
+                pop_to(0);
+                continue;
+            }
+
+            while (ptr[u] < first[u + 1] && remaining[ptr[u]] == 0) ++ptr[u];
+            if (ptr[u] == first[u + 1]) {
+                // No outflow left: only `start` can get here in a conserved flow,
+                // anything else is skipped so a broken flow cannot loop forever
+                pop_to(top - 1);
+                if (top >= 0) ++ptr[stack_v[top]];
+                continue;
+            }
+
+            int a = ptr[u];
+            int v = head(a, u);
+            stack_a[top] = a;
+
+            if (pos[v] != -1) {
+                int from = pos[v];
+                emit(from, true);
+                pop_to(from);
+            } else {
+                stack_v[++top] = v;
+                pos[v] = top;
+            }
+        }
+    };
+
+    // Paths first (cycles through them are split off on the way), then the leftover cycles
+    walk(s, true);
+    for (int u = 0; u < n; ++u) {
+        walk(u, false);
+    }
+
+    return components;
+}
+
+template <typename Cap>
+int write_flow_decomposition(const BasicGraph<Cap>& graph, const BasicFlowState<Cap>& flow, int s, int t, std::ostream& out) {
+    int input_n = graph.num_input_vertices();
+    return decompose_flow<Cap>(graph, flow, s, t, [&out, input_n](bool is_cycle, Cap flow, const int* vertices, int count) {
+        // Drop the super terminals of multi-source/multi-sink problems
+        if (!is_cycle && vertices[0] >= input_n) { ++vertices; --count; }
+        if (!is_cycle && vertices[count - 1] >= input_n) --count;
+
+        out << (is_cycle ? "cycle " : "path ") << flow;
+        for (int i = 0; i < count; ++i) out << " " << vertices[i] + 1;
+        out << "\n";
+    });
+}
+
+template int decompose_flow(const Graph&, const FlowState&, int, int, const FlowComponentVisitor&);
+template int decompose_flow(const Graph64&, const FlowState64&, int, int, const BasicFlowComponentVisitor<long long>&);
+template int write_flow_decomposition(const Graph&, const FlowState&, int, int, std::ostream&);
+template int write_flow_decomposition(const Graph64&, const FlowState64&, int, int, std::ostream&);
@@ -0,0 +1,55 @@
+#include "flow_state.hpp"
+#include <algorithm>
+#include <iostream>
+
+// Flows are interleaved like the arcs when --numa is on (see numa.hpp); a state
+// built by a pinned pool worker stays on that worker's node
+template <typename Cap>
+BasicFlowState<Cap>::BasicFlowState(const Graph& graph) {
+    numa::allocate_interleaved(flows, graph.num_arc_slots());
+}
+
+template <typename Cap>
+void BasicFlowState<Cap>::fit(const Graph& graph) {
+    if (flows.size() < static_cast<size_t>(graph.num_arc_slots())) {
+        std::vector<Cap, huge_pages::Allocator<Cap>> grown;
+        numa::allocate_interleaved(grown, graph.num_arc_slots());
+        std::copy(flows.begin(), flows.end(), grown.begin());
+        flows.swap(grown);
+    }
+}
+
+template <typename Cap>
+void BasicFlowState<Cap>::reset() {
+    std::fill(flows.begin(), flows.end(), 0);
+}
+
+// Net flow leaving node s (outgoing flow minus incoming flow)
+template <typename Cap>
+Cap BasicFlowState<Cap>::flow_value(const Graph& graph, int s) const {
+    Cap sum = 0;
+    for (const Edge& e : graph.adj(s)) {
+        sum += flows[e.arc];
+    }
+    return sum;
+}
+
+// Imprime o grafo residual no terminal
+template <typename Cap>
+void BasicFlowState<Cap>::print_residual_graph(const Graph& graph) const {
+    std::cout << "Residual Graph:\n";
+
+    for (int u = 0; u < graph.size(); ++u) {
+        for (const Edge& e : graph.adj(u)) {
+            // Mostra todas as arestas, inclusive reversas
+            std::cout << "  " << u << " -> " << e.to
+                      << " | cap: " << e.capacity
+                      << " | flow: " << flow(e)
+                      << " | residual: " << remaining_capacity(e)
+                      << "\n";
+        }
+    }
+}
+
+template class BasicFlowState<int>;
+template class BasicFlowState<long long>;
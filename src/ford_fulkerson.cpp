@@ -1,67 +1,74 @@
 #include "ford_fulkerson.hpp"
 #include <algorithm>
-#include <climits>
 #include <cmath>
 #include <limits>
 #include <chrono>
 
 // forward declarations of helpers
-void computeCriticalStats(const Graph& graph, FFStats* stats);
-void populateStats(FFStats* stats,const Graph& graph,int s,int iterations,AlgorithmType type);
+template <typename Cap>
+void computeCriticalStats(const BasicGraph<Cap>& graph, FFStats* stats);
+template <typename Cap>
+void populateStats(FFStats* stats,const BasicGraph<Cap>& graph,int s,int iterations,AlgorithmType type);
 
 
 // Augments the flow along a valid s-t path.
 // Returns how much flow was added (bottleneck capacity).
-int augment(Graph& graph, const Path& path, FFStats* stats) {
-    int bottleneck = INT_MAX;
-    auto& adj = graph.get_adj(); // Reference to adjacency list for flow updates
+template <typename Cap>
+Cap augment(const BasicGraph<Cap>& graph, BasicFlowState<Cap>& flow, const Path& path, FFStats* stats) {
+    using Edge = BasicEdge<Cap>;
+    Cap bottleneck = std::numeric_limits<Cap>::max();
 
     // Find the bottleneck: minimum residual capacity in the path
     for (const auto& [u, idx] : path) {
-        const Edge& e = adj[u][idx];
-        bottleneck = std::min(bottleneck, e.remaining_capacity()); // using method
+        const Edge& e = graph.adj(u)[idx];
+        bottleneck = std::min(bottleneck, flow.remaining_capacity(e)); // using method
     }
 
     // conta *quais* arcos do path serão saturated agora
+    // (one counter per pair, at the slot of its forward half: min(e.arc, rev.arc))
     for (auto [u, idx] : path) {
-        auto& e = adj[u][idx];
-        if (e.remaining_capacity() == bottleneck) {
-            int idx = e.id + stats->offset;
-            ++stats->criticalCount[idx];
+        const Edge& e = graph.adj(u)[idx];
+        if (flow.remaining_capacity(e) == bottleneck) {
+            ++stats->criticalCount[e.arc & ~1];
         }
     }
 
     // Apply the bottleneck flow to the path
     for (const auto& [u, idx] : path) {
-        Edge& e = adj[u][idx];
-        Edge& rev = adj[e.to][e.rev];
-        e.augment(bottleneck, rev); // using method
+        const Edge& e = graph.adj(u)[idx];
+        const Edge& rev = graph.adj(e.to)[e.rev];
+        flow.augment(e, rev, bottleneck); // using method
     }
 
     return bottleneck;
 }
 
 // Repeatedly finds augmenting paths and applies flow until none remain
-int ford_fulkerson(Graph& graph, int s, int t, PathFindingStrategy find_path, AlgorithmType type, FFStats* stats) {
-    int max_flow = 0;
+template <typename Cap>
+Cap ford_fulkerson(const BasicGraph<Cap>& graph, BasicFlowState<Cap>& flow, int s, int t, BasicPathFindingStrategy<Cap> find_path,
+                   AlgorithmType type, FFStats* stats, const std::atomic<bool>* cancel) {
+    Cap max_flow = 0;
     Path path;
     int iterations = 0;
 
+    flow.fit(graph); // arcs may have been added since the flow state was created
+
 	stats->n = graph.num_vertices();
     stats->m = graph.num_edges();
     stats->m_residual = graph.num_edges_residual();
 
-    // Resize the vector to contain a counter per arc, initialized to zero.
-    stats->criticalCount.resize(stats->m_residual, 0);
-    stats->offset = -graph.get_min_edge_id(); 
+    // Resize the vector to one entry per FlowState slot, initialized to zero: as many as
+    // residual arcs, though only the even slots (one per pair) are counted into.
+    // Slots are not reused after Graph::remove_arc, so this may exceed m_residual.
+    stats->criticalCount.resize(graph.num_arc_slots(), 0);
 
     // Start timer
     auto start = std::chrono::high_resolution_clock::now();
 
-    // Main loop: search-augment-repeat
-    while (find_path(graph, s, t, path, stats)) {
+    // Main loop: search-augment-repeat (until done or cancelled)
+    while (!(cancel && cancel->load(std::memory_order_relaxed)) && find_path(graph, flow, s, t, path, stats)) {
         ++iterations;
-        max_flow += augment(graph, path, stats);
+        max_flow += augment(graph, flow, path, stats);
         //std::cerr << "Current max flow: " << max_flow << std::endl;
     }
 
@@ -85,7 +92,8 @@ int ford_fulkerson(Graph& graph, int s, int t, PathFindingStrategy find_path, Al
 
 
 // Helper function to compute critical edge statistics (C_frac and r_bar)
-void computeCriticalStats(const Graph& graph, FFStats* stats) {
+template <typename Cap>
+void computeCriticalStats(const BasicGraph<Cap>& graph, FFStats* stats) {
     int n = graph.size();
     double half_n = n / 2.0;
     int m = stats->criticalCount.size();
@@ -103,13 +111,14 @@ void computeCriticalStats(const Graph& graph, FFStats* stats) {
 }
 
 // Helper function to populate algorithm-specific stats
-void populateStats(FFStats* stats, const Graph& graph, int s, int iterations, AlgorithmType type) {
+template <typename Cap>
+void populateStats(FFStats* stats, const BasicGraph<Cap>& graph, int s, int iterations, AlgorithmType type) {
 
     stats->iterations = iterations;
     stats->n = graph.size();
     stats->m = graph.num_edges();
     stats->m_residual= graph.num_edges_residual();       
-    int C = graph.total_out_capacity(s); 
+    double C = static_cast<double>(graph.total_out_capacity(s));
 
     // ----------------------
     // Compute theoretical upper bound on number of iterations
@@ -117,16 +126,16 @@ void populateStats(FFStats* stats, const Graph& graph, int s, int iterations, Al
     // ----------------------
     switch (type) {
         case AlgorithmType::DFS_RANDOM:
-            stats->bound = static_cast<double>(C);
+            stats->bound = C;
             break;
         case AlgorithmType::BFS_EDMONDS_KARP:
             stats->bound = static_cast<double>(stats->n) * stats->m_residual / 2.0;
             break;
         case AlgorithmType::FATTEST_PATH:
-            stats->bound = stats->m_residual * std::log2(std::max(1, C));
+            stats->bound = stats->m_residual * std::log2(std::max(1.0, C));
             break;
         case AlgorithmType::CAPACITY_SCALING:
-            stats->bound = stats->m_residual * std::log2(std::max(1, C));
+            stats->bound = stats->m_residual * std::log2(std::max(1.0, C));
             break;
     }
 
@@ -208,4 +217,10 @@ void populateStats(FFStats* stats, const Graph& graph, int s, int iterations, Al
     stats->time_over_I_sntm = (I > 0 && stats->n > 0 && stats->m_residual > 0)
         ? T / (I * (stats->s_bar * stats->n + stats->t_bar_residual * stats->m_residual)) : 0.0;
 
-}
\ No newline at end of file
+}
+
+template int augment(const Graph&, FlowState&, const Path&, FFStats*);
+template long long augment(const Graph64&, FlowState64&, const Path&, FFStats*);
+template int ford_fulkerson(const Graph&, FlowState&, int, int, PathFindingStrategy, AlgorithmType, FFStats*, const std::atomic<bool>*);
+template long long ford_fulkerson(const Graph64&, FlowState64&, int, int, BasicPathFindingStrategy<long long>, AlgorithmType, FFStats*,
+                                  const std::atomic<bool>*);
@@ -0,0 +1,336 @@
+#include "generators.hpp"
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace generators {
+
+Random::Random(unsigned seed) {
+    // srandom(): a Park-Miller sequence fills the state, then 310 outputs are dropped
+    int32_t word = static_cast<int32_t>(seed == 0 ? 1 : seed);
+    state[0] = static_cast<uint32_t>(word);
+    for (int i = 1; i < 31; ++i) {
+        int32_t hi = word / 127773;
+        int32_t lo = word % 127773;
+        word = 16807 * lo - 2836 * hi;
+        if (word < 0) word += 2147483647;
+        state[i] = static_cast<uint32_t>(word);
+    }
+    for (int i = 0; i < 310; ++i) next();
+}
+
+int32_t Random::next() {
+    state[front] += state[rear];
+    int32_t result = static_cast<int32_t>(state[front] >> 1);
+    front = (front + 1) % 31;
+    rear = (rear + 1) % 31;
+    return result;
+}
+
+int32_t Random::integer(int32_t low, int32_t high) {
+    return next() % (high - low + 1) + low;
+}
+
+void Random::subset(int32_t low, int32_t high, int count, int32_t* x) {
+    if (high - low + 1 < count) {
+        throw std::runtime_error("Invalid range for random subset");
+    }
+    // Rejection of repeated draws, as in new_washington.c (keeps the same stream)
+    for (int i = 0; i < count;) {
+        int32_t r = integer(low, high);
+        bool repeated = false;
+        for (int j = 0; j < i; ++j) {
+            if (x[j] == r) repeated = true;
+        }
+        if (!repeated) x[i++] = r;
+    }
+}
+
+namespace {
+    // Halving capacity ranges of the exponential lines, by distance class
+    const int32_t ranges[] = {1000000, 500000, 250000, 125000, 62500, 31250, 15625, 7812, 3906, 1953,
+                              976, 488, 244, 122, 61, 31, 15, 7, 4, 2};
+    constexpr int num_ranges = sizeof(ranges) / sizeof(ranges[0]);
+
+    void check_size(long long n) {
+        if (n > std::numeric_limits<int>::max()) {
+            throw std::runtime_error("Graph out of range");
+        }
+    }
+
+    // Lays out the recorded arcs and makes 0 the source and the last vertex the sink
+    Graph finish(Graph& graph) {
+        graph.compress_graph();
+        graph.set_terminals({0}, {graph.size() - 1});
+        return std::move(graph);
+    }
+
+    // Source and sink arcs shared by the mesh and leveled families: s feeds the
+    // first `width` vertices and the last `width` ones feed t
+    void add_terminal_arcs(Graph& graph, int width, int capacity) {
+        int sink = graph.size() - 1;
+        for (int i = 1; i <= width; ++i) {
+            graph.add_edge(0, i, capacity);
+            graph.add_edge(sink - i, sink, capacity);
+        }
+    }
+} // namespace
+
+Graph mesh(int rows, int cols, int range, unsigned seed) {
+    if (rows < 2 || cols < 2) throw std::runtime_error("Degenerate graph");
+    check_size(1LL * rows * cols + 2);
+
+    Random rng(seed);
+    Graph graph(rows * cols + 2);
+    add_terminal_arcs(graph, rows, 3 * range);
+
+    // Each vertex feeds its three neighbours of the next column, wrapping around
+    for (int i = 0; i < cols - 1; ++i) {
+        int u = i * rows, v = (i + 1) * rows;
+        graph.add_edge(u + 1, v + rows, rng.integer(1, range));
+        graph.add_edge(u + 1, v + 1, rng.integer(1, range));
+        graph.add_edge(u + 1, v + 2, rng.integer(1, range));
+        for (int j = 2; j <= rows - 1; ++j) {
+            graph.add_edge(u + j, v + j - 1, rng.integer(1, range));
+            graph.add_edge(u + j, v + j, rng.integer(1, range));
+            graph.add_edge(u + j, v + j + 1, rng.integer(1, range));
+        }
+        graph.add_edge(u + rows, v + rows - 1, rng.integer(1, range));
+        graph.add_edge(u + rows, v + rows, rng.integer(1, range));
+        graph.add_edge(u + rows, v + 1, rng.integer(1, range));
+    }
+    return finish(graph);
+}
+
+Graph random_level(int rows, int cols, int range, unsigned seed) {
+    if (rows < 2 || cols < 2) throw std::runtime_error("Degenerate graph");
+    check_size(1LL * rows * cols + 2);
+
+    Random rng(seed);
+    Graph graph(rows * cols + 2);
+    add_terminal_arcs(graph, rows, 3 * range);
+
+    // Three distinct random targets in the next level
+    int32_t x[3];
+    for (int i = 0; i < cols - 1; ++i) {
+        for (int j = 1; j <= rows; ++j) {
+            rng.subset(1, rows, 3, x);
+            for (int k = 0; k < 3; ++k) {
+                graph.add_edge(i * rows + j, (i + 1) * rows + x[k], rng.integer(1, range));
+            }
+        }
+    }
+    return finish(graph);
+}
+
+Graph random_2level(int rows, int cols, int range, unsigned seed) {
+    if (rows < 2 || cols < 2) throw std::runtime_error("Degenerate graph");
+    check_size(1LL * rows * cols + 2);
+
+    Random rng(seed);
+    Graph graph(rows * cols + 2);
+    add_terminal_arcs(graph, rows, 3 * range);
+
+    // Targets anywhere in the next two levels, and in the last level from the one before.
+    // (new_washington.c indexes that last level as (rows - 1) * rows, which is only
+    // inside the graph for square instances; (cols - 1) * rows is the same there.)
+    int32_t x[3];
+    for (int i = 0; i < cols - 2; ++i) {
+        for (int j = 1; j <= rows; ++j) {
+            rng.subset(1, 2 * rows, 3, x);
+            for (int k = 0; k < 3; ++k) {
+                graph.add_edge(i * rows + j, (i + 1) * rows + x[k], rng.integer(1, range));
+            }
+        }
+    }
+    for (int j = 1; j <= rows; ++j) {
+        rng.subset(1, rows, 3, x);
+        for (int k = 0; k < 3; ++k) {
+            graph.add_edge((cols - 2) * rows + j, (cols - 1) * rows + x[k], rng.integer(1, range));
+        }
+    }
+    return finish(graph);
+}
+
+Graph matching(int n, int degree, int range, unsigned seed) {
+    if (n < 2 || degree > n) throw std::runtime_error("Degenerate graph");
+    check_size(2LL * n + 2);
+
+    Random rng(seed);
+    Graph graph(2 * n + 2);
+    add_terminal_arcs(graph, n, range);
+
+    // Each left vertex j is joined to `degree` distinct right vertices n + x
+    std::vector<int32_t> x(degree);
+    for (int j = 1; j <= n; ++j) {
+        rng.subset(1, n, degree, x.data());
+        for (int i = 0; i < degree; ++i) {
+            graph.add_edge(j, n + x[i], range);
+        }
+    }
+    return finish(graph);
+}
+
+Graph square_mesh(int side, int degree, int range, unsigned seed) {
+    if (side < degree) throw std::runtime_error("Degenerate graph");
+    check_size(1LL * side * side + 2);
+
+    Random rng(seed);
+    Graph graph(side * side + 2);
+    add_terminal_arcs(graph, side, 3 * range);
+
+    // Each vertex feeds the next `degree` vertices of the next row
+    int sink = graph.size() - 1;
+    for (int i = 0; i < side - 1; ++i) {
+        for (int j = 1; j <= side; ++j) {
+            for (int k = 0; k < degree; ++k) {
+                if ((i + 1) * side + j + k <= sink - 1) {
+                    graph.add_edge(i * side + j, (i + 1) * side + j + k, rng.integer(1, range));
+                }
+            }
+        }
+    }
+    return finish(graph);
+}
+
+// The three line families: vertices in a row, each with `degree` arcs to random
+// vertices ahead (and behind, for the double exponential line). `capacity` gives the
+// capacity of an arc spanning offset x.
+template <typename Capacity>
+static Graph line(int n, int m, int degree, int range, int32_t low, Random& rng, Capacity capacity) {
+    check_size(1LL * n * m + 2);
+
+    Graph graph(n * m + 2);
+    int sink = graph.size() - 1;
+    add_terminal_arcs(graph, m, degree * range);
+
+    std::vector<int32_t> x(degree);
+    for (int i = 1; i < sink; ++i) {
+        rng.subset(low, m * degree, degree, x.data());
+        for (int j = 0; j < degree; ++j) {
+            if (i + x[j] < sink && i + x[j] > 0 && x[j] != 0) {
+                graph.add_edge(i, i + x[j], capacity(x[j]));
+            }
+        }
+    }
+    return finish(graph);
+}
+
+Graph basic_line(int n, int m, int degree, int range, unsigned seed) {
+    Random rng(seed);
+    return line(n, m, degree, range, 1, rng, [&](int32_t) { return rng.integer(1, range); });
+}
+
+Graph exponential_line(int n, int m, int degree, int range, unsigned seed) {
+    if (degree > num_ranges) throw std::runtime_error("Degree out of range");
+    Random rng(seed);
+    return line(n, m, degree, range, 1, rng, [&](int32_t x) { return rng.integer(1, ranges[(x - 1) / m]); });
+}
+
+Graph double_exponential_line(int n, int m, int degree, int range, unsigned seed) {
+    if (degree >= num_ranges) throw std::runtime_error("Degree out of range");
+    Random rng(seed);
+    return line(n, m, degree, range, -m * degree, rng,
+                [&](int32_t x) { return rng.integer(1, ranges[std::abs((x - 1) / m)]); });
+}
+
+Graph dinic_bad_case(int n) {
+    if (n < 2) throw std::runtime_error("Degenerate graph");
+
+    // A path 0 -> 1 -> ... -> n-1 plus unit shortcuts to t from all but the last two vertices,
+    // so every Dinic phase finds a single augmenting path
+    Graph graph(n);
+    for (int i = 0; i < n - 1; ++i) graph.add_edge(i, i + 1, n);
+    for (int i = 0; i < n - 2; ++i) graph.add_edge(i, n - 1, 1);
+    return finish(graph);
+}
+
+Graph gold_bad_case(int n) {
+    if (n < 1) throw std::runtime_error("Degenerate graph");
+    check_size(3LL * n + 3);
+
+    // n unit arcs in parallel between a fan out of vertex 1 and a line into t
+    Graph graph(3 * n + 3);
+    graph.add_edge(0, 1, n);
+    for (int i = 2; i < n + 2; ++i) {
+        graph.add_edge(1, i, n);
+        graph.add_edge(i, i + n, 1);
+        graph.add_edge(i + n, 2 * n + 2, n);
+    }
+    for (int i = 2 * n + 2; i < 3 * n + 2; ++i) graph.add_edge(i, i + 1, n);
+    return finish(graph);
+}
+
+Graph cheryian(int n, int m, int c, int very_big) {
+    // Four gadgets between terminals 0..3, a bridge from 1 to 2 and an arc from 3 to t
+    long long size = 4LL * m * c + 2LL * n + 7;
+    check_size(size);
+
+    Graph graph(static_cast<int>(size));
+    int next_vertex = 4;
+
+    // m chains of c vertices ending at b, each fed by an arc from a of capacity n
+    auto gadget = [&](int a, int b) {
+        int v = b;
+        for (int i = 0; i < m; ++i) {
+            for (int j = 0; j < c; ++j) {
+                int w = v;
+                v = next_vertex++;
+                graph.add_edge(v, w, very_big);
+            }
+            graph.add_edge(a, v, n);
+        }
+    };
+    gadget(0, 1);
+    gadget(0, 2);
+    gadget(1, 3);
+    gadget(2, 3);
+
+    int v1 = next_vertex++;
+    int v2 = next_vertex++;
+    graph.add_edge(1, v1, n);
+    graph.add_edge(v2, 2, n);
+    for (int i = 0; i < n; ++i) {
+        int v = next_vertex++;
+        int w = next_vertex++;
+        graph.add_edge(v1, v, n);
+        graph.add_edge(w, v2, n);
+        graph.add_edge(v, w, 1);
+    }
+
+    graph.add_edge(3, next_vertex++, very_big);
+    return finish(graph);
+}
+
+Graph generate(int type, const std::vector<int>& params, unsigned seed) {
+    static const int num_params[] = {0, 3, 3, 3, 3, 3, 4, 4, 4, 1, 1, 4, 3};
+    if (type < 1 || type > 12) {
+        throw std::runtime_error("Unknown graph family: " + std::to_string(type));
+    }
+    if (static_cast<int>(params.size()) != num_params[type]) {
+        throw std::runtime_error("Graph family " + std::to_string(type) + " takes " +
+                                 std::to_string(num_params[type]) + " parameters");
+    }
+
+    const std::vector<int>& p = params;
+    switch (type) {
+        case 1: return mesh(p[0], p[1], p[2], seed);
+        case 2: return random_level(p[0], p[1], p[2], seed);
+        // On purpose: new_washington.c also calls RLevel for type 3 (only its header
+        // comment says "Random 2 Leveled Graph"), and type 3 must stay the gengraph graph
+        case 3: return random_level(p[0], p[1], p[2], seed);
+        case 4: return matching(p[0], p[1], p[2], seed);
+        case 5: return square_mesh(p[0], p[1], p[2], seed);
+        case 6: return basic_line(p[0], p[1], p[2], p[3], seed);
+        case 7: return exponential_line(p[0], p[1], p[2], p[3], seed);
+        case 8: return double_exponential_line(p[0], p[1], p[2], p[3], seed);
+        case 9: return dinic_bad_case(p[0]);
+        case 10: return gold_bad_case(p[0]);
+        case 11: return cheryian(p[0], p[1], p[2], p[3]);
+        default: return random_2level(p[0], p[1], p[2], seed);
+    }
+}
+
+} // namespace generators
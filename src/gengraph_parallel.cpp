@@ -0,0 +1,55 @@
+#include "parallel_generator.hpp"
+#include "thread_pool.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Writes a large mesh (1), random leveled (2) or matching (4) graph as a CSR file,
+// with the parameters of gengraph for the same family:
+//   gengraph_parallel 1 rows cols range arquivo.csr [--threads k] [--seed s]
+//   gengraph_parallel 4 n degree range arquivo.csr
+int main(int argc, char* argv[]) {
+    if (argc < 6) {
+        std::cerr << "Uso: " << argv[0] << " 1|2|4 p1 p2 p3 arquivo.csr [--threads k] [--seed s]\n"
+                  << "  1 mesh: rows cols range, 2 random level: rows cols range, 4 matching: n degree range\n";
+        return 1;
+    }
+
+    parallel_generator::Family family;
+    std::string path;
+    int workers = thread_pool::default_workers();
+    uint64_t seed = 1;
+    try {
+        family.type = std::stoi(argv[1]);
+        for (int i = 2; i < 5; ++i) family.params.push_back(std::stoll(argv[i]));
+        path = argv[5];
+        for (int i = 6; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--threads" && i + 1 < argc) {
+                workers = std::stoi(argv[++i]);
+            } else if (arg == "--seed" && i + 1 < argc) {
+                seed = std::stoull(argv[++i]);
+            } else {
+                std::cerr << "Opcao inválida: " << arg << "\n";
+                return 1;
+            }
+        }
+    } catch (const std::logic_error&) {
+        std::cerr << "Parametro inválido\n";
+        return 1;
+    }
+
+    try {
+        auto start = std::chrono::steady_clock::now();
+        csr::Header header = parallel_generator::write_csr(family, seed, workers, path);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cerr << "n: " << header.n << ", m: " << header.m << ", " << elapsed.count() << " s\n";
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include "gomory_hu.hpp"
+#include "min_cut.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+
+template <typename Cap>
+Cap BasicGomoryHuTree<Cap>::min_cut(int u, int v) const {
+    if (u == v) return std::numeric_limits<Cap>::max();
+
+    // Depth of each endpoint, then climb the deeper one until they meet
+    auto depth = [this](int x) {
+        int d = 0;
+        for (; parent[x] != -1; x = parent[x]) ++d;
+        return d;
+    };
+
+    int du = depth(u), dv = depth(v);
+    Cap best = std::numeric_limits<Cap>::max();
+    while (u != v) {
+        if (du >= dv) {
+            best = std::min(best, weight[u]);
+            u = parent[u];
+            --du;
+        } else {
+            best = std::min(best, weight[v]);
+            v = parent[v];
+            --dv;
+        }
+    }
+    return best;
+}
+
+template <typename Cap>
+BasicGomoryHuTree<Cap> gomory_hu_tree(const BasicGraph<Cap>& graph, const BasicMaxFlowSolver<Cap>& solve, int workers) {
+    int n = graph.size();
+
+    BasicGraph<Cap> undirected = graph;
+    undirected.make_undirected();
+
+    BasicGomoryHuTree<Cap> tree;
+    tree.parent.assign(n, 0);
+    tree.weight.assign(n, 0);
+    if (n == 0) return tree;
+    tree.parent[0] = -1;
+
+    workers = std::max(1, std::min(workers, n - 1));
+
+    std::mutex mtx;
+    std::condition_variable committed_cv;
+    int committed = 1;                // vertices < committed have their final parent and weight
+    std::atomic<int> next_vertex{1};
+
+    thread_pool::run(workers, [&](int) {
+        BasicFlowState<Cap> flow(undirected);   // private flows for this worker
+
+        for (int s = next_vertex++; s < n; s = next_vertex++) {
+            while (true) {
+                int t;
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    t = tree.parent[s];
+                }
+
+                flow.reset();
+                Cap value = solve(undirected, flow, s, t);
+                std::vector<char> side = residual_source_side(undirected, flow, s);
+
+                // Commit in vertex order, since cut s may re-parent vertices > s
+                std::unique_lock<std::mutex> lock(mtx);
+                committed_cv.wait(lock, [&] { return committed == s; });
+                if (tree.parent[s] != t) {
+                    continue; // an earlier cut moved s, parent is final now
+                }
+
+                tree.weight[s] = value;
+                for (int i = s + 1; i < n; ++i) {
+                    if (side[i] && tree.parent[i] == t) tree.parent[i] = s;
+                }
+                ++committed;
+                committed_cv.notify_all();
+                break;
+            }
+        }
+    });
+
+    return tree;
+}
+
+template <typename Cap>
+void write_gomory_hu_tree(const BasicGomoryHuTree<Cap>& tree, std::ostream& out) {
+    int n = tree.parent.size();
+    out << "p ghtree " << n << "\n";
+    for (int v = 0; v < n; ++v) {
+        if (tree.parent[v] == -1) continue;
+        out << "e " << v + 1 << " " << tree.parent[v] + 1 << " " << tree.weight[v] << "\n";
+    }
+}
+
+template struct BasicGomoryHuTree<int>;
+template struct BasicGomoryHuTree<long long>;
+template GomoryHuTree gomory_hu_tree(const Graph&, const MaxFlowSolver&, int);
+template GomoryHuTree64 gomory_hu_tree(const Graph64&, const BasicMaxFlowSolver<long long>&, int);
+template void write_gomory_hu_tree(const GomoryHuTree&, std::ostream&);
+template void write_gomory_hu_tree(const GomoryHuTree64&, std::ostream&);
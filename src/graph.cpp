@@ -1,201 +1,707 @@
 // graph.cpp
 #include "graph.hpp"
+#include "flow_state.hpp"
+#include "numa.hpp"
+#include "csr.hpp"
 #include <sstream>
 #include <stdexcept>
 #include <iostream> //debug for residual graph
-#include <map>
-#include <set>
+#include <cstdlib>
 #include <limits>
+#include <algorithm>
 
 
 // Constructor that initializes the graph with n nodes
-Graph::Graph(int n) : n(n), adj_list(n) {}
-
-// Adds a forward and reverse edge (for residual graph) between 'from' and 'to'
-void Graph::add_edge(int from, int to, int capacity) {
-    int fid = next_edge_id++;   // ID for forward edge
-    int rid = next_edge_id_reverse--;
-    // Forward edge: from → to with given capacity
-    Edge forward = {fid, to, from, static_cast<int>(adj_list[to].size()), capacity, 0};
-    // Reverse edge: to → from with 0 capacity (initially) and fid = -1 to sinalize it is a backward edge, used for flow cancellation
-    Edge backward = {rid, from, to, static_cast<int>(adj_list[from].size()), 0, 0};
+template <typename Cap>
+BasicGraph<Cap>::BasicGraph(int n) : n(n), input_n(n), lists(n) {}
+
+// Same arcs and flow slots, with capacities converted to Cap
+template <typename Cap>
+template <typename Other>
+BasicGraph<Cap>::BasicGraph(const BasicGraph<Other>& other)
+    : n(other.n), input_n(other.input_n), source(other.source), sink(other.sink), next_arc(other.next_arc),
+      sources(other.sources), sinks(other.sinks), lowered(other.lowered), removed(other.removed) {
+    // Placed like compress_graph places them (see numa.hpp)
+    numa::allocate_interleaved(arcs, other.arcs.size());
+    for (size_t i = 0; i < arcs.size(); ++i) {
+        const auto& e = other.arcs[i];
+        arcs[i] = {e.to, e.rev, e.arc, static_cast<Cap>(e.capacity)};
+    }
+    numa::allocate_interleaved(lists, other.lists.size());
+    for (size_t i = 0; i < lists.size(); ++i) {
+        lists[i] = {other.lists[i].first, other.lists[i].degree, other.lists[i].room};
+    }
+    pending.reserve(other.pending.size());
+    for (const auto& a : other.pending) {
+        pending.push_back({a.from, a.to, static_cast<Cap>(a.capacity)});
+    }
+}
 
-    adj_list[from].push_back(forward);
-    adj_list[to].push_back(backward);
+// Records an arc 'from' -> 'to'; compress_graph turns it into a forward/reverse pair
+template <typename Cap>
+void BasicGraph<Cap>::add_edge(int from, int to, Cap capacity) {
+    pending.push_back({from, to, capacity});
 }
 
-int Graph::size() const {
+template <typename Cap>
+int BasicGraph<Cap>::size() const {
     return n;
 }
 
-int Graph::num_vertices() const {
+template <typename Cap>
+int BasicGraph<Cap>::num_vertices() const {
     return size();
 }
 
 // Count only edges with positive capacity (original forward edges)
-int Graph::num_edges() const {
+template <typename Cap>
+int BasicGraph<Cap>::num_edges() const {
     int count = 0;
-    for (const auto& vec : adj_list) {
-        for (const Edge& e : vec) {
+    for (int u = 0; u < n; ++u) {
+        for (const Edge& e : adj(u)) {
             if (e.capacity > 0) ++count;
         }
     }
     return count;
 }
 
-int Graph::num_edges_residual() const {
+template <typename Cap>
+int BasicGraph<Cap>::num_edges_residual() const {
     int count = 0;
-    for (const auto& neighbors : adj_list) {
-        for ([[maybe_unused]]const Edge& e : neighbors) {
-            count++;
-        }
+    for (const ArcList& l : lists) {
+        count += l.degree;
     }
     return count;
 }
 
-int Graph::get_min_edge_id() const {
-    int min_id = std::numeric_limits<int>::max();
-    for (const auto& neighbors : adj_list) {
-        for (const Edge& e : neighbors) {
-            min_id = std::min(min_id, e.id);
+// Sum of capacities of all outgoing edges from node s
+template <typename Cap>
+Cap BasicGraph<Cap>::total_out_capacity(int s) const {
+    Cap sum = 0;
+    for (const Edge& e : adj(s)) {
+        sum += e.capacity;
+    }
+    return sum;
+}
+
+// Largest total capacity around a node, arcs in both directions
+template <typename Cap>
+Cap BasicGraph<Cap>::max_incident_capacity() const {
+    Cap best = 0;
+    for (int u = 0; u < n; ++u) {
+        Cap sum = 0;
+        for (const Edge& e : adj(u)) {
+            sum += e.capacity + adj(e.to)[e.rev].capacity;
         }
+        best = std::max(best, sum);
     }
-    return min_id;
+    return best;
 }
 
-// Sum of capacities of all outgoing edges from node s
-int Graph::total_out_capacity(int s) const {
-    int sum = 0;
-    for ( const Edge& e : adj_list[s]) {
-        sum += e.capacity;
+template <typename Cap>
+int BasicGraph<Cap>::num_arc_slots() const {
+    return next_arc;
+}
+
+// Returns the index of the arc u -> v inside adj(u), or -1 if there is none.
+// After compress_graph there is at most one such arc per ordered pair.
+template <typename Cap>
+int BasicGraph<Cap>::find_arc(int u, int v) const {
+    const auto neighbors = adj(u);
+    for (size_t i = 0; i < neighbors.size(); ++i) {
+        if (neighbors[i].to == v) return static_cast<int>(i);
     }
-    return sum;
+    return -1;
 }
 
-// Returns the adjacency list of a given node
-const std::vector<Edge>& Graph::adj(int u) const {
-    return adj_list[u];
+// Changes the capacity of arc u -> v without touching any flow.
+// Lowered arcs are remembered, so repair_flow() only has to look at the
+// arcs that were actually edited.
+template <typename Cap>
+void BasicGraph<Cap>::set_capacity(int u, int v, Cap capacity) {
+    if (capacity < 0) {
+        throw std::runtime_error("Capacity must be non-negative");
+    }
+    int idx = find_arc(u, v);
+    if (idx == -1) {
+        throw std::runtime_error("Arc " + std::to_string(u) + " -> " + std::to_string(v) + " does not exist");
+    }
+
+    Edge& e = list(u)[idx];
+    if (capacity < e.capacity) {
+        lowered.push_back({u, v});
+    }
+    e.capacity = capacity;
+    grow_super_arcs(u, v);
 }
 
-// Returns the list of edges from node u (same as adj)
-const std::vector<Edge>& Graph::get_neighbors(int u) const {
-    return adj_list[u];
+template <typename Cap>
+const std::vector<std::pair<int, int>>& BasicGraph<Cap>::lowered_arcs() const {
+    return lowered;
+}
+
+template <typename Cap>
+void BasicGraph<Cap>::clear_lowered_arcs() {
+    lowered.clear();
+}
+
+template <typename Cap>
+void BasicGraph<Cap>::check_vertex(int u) const {
+    if (u < 0 || u >= n) {
+        throw std::runtime_error("Vertex " + std::to_string(u) + " out of range");
+    }
+}
+
+// Adds an arc u -> v after compress_graph. If the pair {u, v} is already
+// present the capacity is merged into it, exactly like compress_graph does
+// for parallel arcs, otherwise a new forward/reverse pair is appended.
+template <typename Cap>
+void BasicGraph<Cap>::add_arc(int u, int v, Cap capacity) {
+    check_vertex(u);
+    check_vertex(v);
+    if (u == v) {
+        throw std::runtime_error("Self-loops are not supported");
+    }
+    if (capacity < 0) {
+        throw std::runtime_error("Capacity must be non-negative");
+    }
+
+    int idx = find_arc(u, v);
+    if (idx != -1) {
+        list(u)[idx].capacity += capacity;
+    } else {
+        append_pair(u, v, capacity);
+    }
+    grow_super_arcs(u, v);
 }
 
-// Returns the full adjacency list for modifying flows
-std::vector<std::vector<Edge>>& Graph::get_adj() {
-    return adj_list;
+template <typename Cap>
+BasicEdge<Cap>* BasicGraph<Cap>::list(int u) {
+    return arcs.data() + lists[u].first;
 }
 
-int Graph::get_source() const {
+// Appends e to the list of u. A full list moves to the end of the block with
+// twice the room; reverse indices count from the start of a list, so they stay valid.
+template <typename Cap>
+void BasicGraph<Cap>::push_arc(int u, const Edge& e) {
+    ArcList& l = lists[u];
+    if (l.degree == l.room) {
+        size_t first = arcs.size();
+        int room = std::max(4, 2 * l.room);
+        arcs.resize(first + room);
+        std::copy(arcs.begin() + l.first, arcs.begin() + l.first + l.degree, arcs.begin() + first);
+        l.first = first;
+        l.room = room;
+    }
+    arcs[l.first + l.degree++] = e;
+}
+
+// Appends a new merged pair u -> v without looking for an existing one
+template <typename Cap>
+void BasicGraph<Cap>::append_pair(int u, int v, Cap capacity) {
+    Edge forward = {v, lists[v].degree, next_arc++, capacity};
+    Edge backward = {u, lists[u].degree, next_arc++, 0};
+    push_arc(u, forward);
+    push_arc(v, backward);
+}
+
+// Removes the capacity of u -> v. The pair stays in place (with a lowered
+// arc) until repair_flow has drained its flow, and is then erased by
+// purge_removed_arcs if v -> u has no capacity either.
+template <typename Cap>
+void BasicGraph<Cap>::remove_arc(int u, int v) {
+    check_vertex(u);
+    check_vertex(v);
+    set_capacity(u, v, 0);
+    removed.push_back({u, v});
+}
+
+template <typename Cap>
+void BasicGraph<Cap>::purge_removed_arcs(const BasicFlowState<Cap>& state) {
+    for (const auto& [u, v] : removed) {
+        erase_unused_pair(u, v, state);
+    }
+    removed.clear();
+}
+
+// Erases the pair {u, v} if it has neither capacity nor flow left.
+// Both halves are swapped with the last arc of their list, so only the
+// reverse index of the two moved arcs has to be fixed.
+template <typename Cap>
+bool BasicGraph<Cap>::erase_unused_pair(int u, int v, const BasicFlowState<Cap>& state) {
+    int iu = find_arc(u, v);
+    if (iu == -1) return true;
+
+    int iv = adj(u)[iu].rev;
+    const Edge& e = adj(u)[iu];
+    const Edge& r = adj(v)[iv];
+    if (e.capacity != 0 || r.capacity != 0 || state.flow(e) != 0) return false;
+
+    auto erase_at = [this](int x, int i) {
+        Edge* arcs_x = list(x);
+        int last = --lists[x].degree;
+        if (i != last) {
+            arcs_x[i] = arcs_x[last];
+            const Edge& moved = arcs_x[i];
+            list(moved.to)[moved.rev].rev = i;
+        }
+    };
+    erase_at(u, iu);
+    erase_at(v, iv);
+    return true;
+}
+
+// Returns the adjacency list of a given node
+template <typename Cap>
+EdgeRange<BasicEdge<Cap>> BasicGraph<Cap>::adj(int u) const {
+    return {arcs.data() + lists[u].first, lists[u].degree};
+}
+
+// Returns the list of edges from node u (same as adj)
+template <typename Cap>
+EdgeRange<BasicEdge<Cap>> BasicGraph<Cap>::get_neighbors(int u) const {
+    return adj(u);
+}
+
+template <typename Cap>
+int BasicGraph<Cap>::get_source() const {
     return source;
 }
 
-int Graph::get_sink() const {
+template <typename Cap>
+int BasicGraph<Cap>::get_sink() const {
     return sink;
 }
 
-// Reads a graph in DIMACS max-flow format from an input stream
-void Graph::read_dimacs(std::istream& in) {
+template <typename Cap>
+const std::vector<int>& BasicGraph<Cap>::get_sources() const {
+    return sources;
+}
+
+template <typename Cap>
+const std::vector<int>& BasicGraph<Cap>::get_sinks() const {
+    return sinks;
+}
+
+template <typename Cap>
+int BasicGraph<Cap>::num_input_vertices() const {
+    return input_n;
+}
+
+// Sets the terminal sets of the problem. A single source/sink is used as is;
+// a larger set gets a super terminal appended after the existing vertices, so
+// the adjacency lists are extended in place instead of rebuilding the graph.
+template <typename Cap>
+void BasicGraph<Cap>::set_terminals(const std::vector<int>& new_sources, const std::vector<int>& new_sinks) {
+    if (n != input_n) {
+        throw std::runtime_error("Terminals were already set");
+    }
+    if (new_sources.empty() || new_sinks.empty()) {
+        throw std::runtime_error("Source or sink node not defined");
+    }
+
+    std::vector<char> role(n, 0);
+    for (int v : new_sources) {
+        check_vertex(v);
+        role[v] = 's';
+    }
+    for (int v : new_sinks) {
+        check_vertex(v);
+        if (role[v] == 's') {
+            throw std::runtime_error("Vertex " + std::to_string(v + 1) + " is both source and sink");
+        }
+        role[v] = 't';
+    }
+
+    // Keep each terminal once, in input order
+    sources.clear();
+    sinks.clear();
+    for (int v : new_sources) {
+        if (role[v] == 's') { sources.push_back(v); role[v] = 0; }
+    }
+    for (int v : new_sinks) {
+        if (role[v] == 't') { sinks.push_back(v); role[v] = 0; }
+    }
+
+    source = (sources.size() == 1) ? sources[0] : add_super_terminal(sources, true);
+    sink   = (sinks.size() == 1)   ? sinks[0]   : add_super_terminal(sinks, false);
+}
+
+// Appends a vertex connected to every terminal. The arc capacities are the total
+// capacity leaving (entering) the terminal, which never limits the flow; set_capacity
+// and add_arc keep it that way (see grow_super_arcs).
+template <typename Cap>
+int BasicGraph<Cap>::add_super_terminal(const std::vector<int>& terminals, bool is_source) {
+    int super = n++;
+    lists.emplace_back();
+
+    for (int v : terminals) {
+        Cap cap = 0;
+        for (const Edge& e : adj(v)) {
+            cap += is_source ? e.capacity : adj(e.to)[e.rev].capacity;
+        }
+        if (is_source) {
+            append_pair(super, v, cap);
+        } else {
+            append_pair(v, super, cap);
+        }
+    }
+
+    return super;
+}
+
+// After u -> v was raised or added: if u is one of several sources, raises its arc
+// from the super source to u's total outgoing capacity, and if v is one of several
+// sinks, its arc to the super sink to v's total incoming capacity. Lowered edits leave
+// the super arcs larger than needed, which is harmless. Edits of super arcs are kept.
+template <typename Cap>
+void BasicGraph<Cap>::grow_super_arcs(int u, int v) {
+    if (u >= input_n || v >= input_n) return;
+
+    auto grow = [this](int terminal, int super, bool is_source) {
+        int idx = find_arc(terminal, super);
+        if (idx == -1) return; // not in that terminal set
+        Cap total = 0;
+        for (const Edge& e : adj(terminal)) {
+            if (e.to != super) total += is_source ? e.capacity : adj(e.to)[e.rev].capacity;
+        }
+        Edge& half = list(terminal)[idx];
+        Edge& arc = is_source ? list(super)[half.rev] : half;
+        arc.capacity = std::max(arc.capacity, total);
+    };
+    if (source >= input_n) grow(u, source, true);
+    if (sink >= input_n) grow(v, sink, false);
+}
+
+// Parses DIMACS max-flow text: start(n, m) on the problem line, then arc(from, to,
+// capacity) for every arc line, with 0-based vertices, and the terminal sets
+template <typename Start, typename Arc>
+static void parse_dimacs(std::istream& in, Start start, Arc arc, std::vector<int>& sources, std::vector<int>& sinks) {
     std::string line;
+    long long n = 0;
     while (std::getline(in, line)) {
         if (line.empty() || line[0] == 'c') continue; // Skip comments
 
+        if (line[0] == 'a') {
+            // Arc lines are nearly the whole file: parsed in place, without a stream per line
+            char* cursor = &line[1];
+            long long from = std::strtoll(cursor, &cursor, 10);
+            long long to = std::strtoll(cursor, &cursor, 10);
+            long long cap = std::strtoll(cursor, &cursor, 10);
+            if (from < 1 || from > n || to < 1 || to > n) {
+                throw std::runtime_error("Arc out of range: " + line);
+            }
+            arc(static_cast<int>(from - 1), static_cast<int>(to - 1), cap);
+            continue;
+        }
+
         std::istringstream iss(line);
         char type;
         iss >> type;
 
         if (type == 'p') {
             std::string problem_type;
-            int nodes, arcs;
-            iss >> problem_type >> nodes >> arcs;
+            int nodes, edges;
+            iss >> problem_type >> nodes >> edges;
             if (problem_type != "max") {
                 throw std::runtime_error("Only 'max' problems are supported");
             }
             n = nodes;
-            adj_list.assign(n, {});
+            start(nodes, static_cast<size_t>(std::max(edges, 0)));
         } else if (type == 'n') {
             int id;
             char role;
             iss >> id >> role;
-            if (role == 's') source = id - 1;
-            if (role == 't') sink = id - 1;
-        } else if (type == 'a') {
-            int from, to, cap;
-            iss >> from >> to >> cap;
-            add_edge(from - 1, to - 1, cap);
-            //std::cout << "Adding edge: " << from - 1 << " -> " << to - 1 << " with capacity " << cap << std::endl;
-
+            if (role == 's') sources.push_back(id - 1);
+            if (role == 't') sinks.push_back(id - 1);
         }
     }
 
+    if (sources.empty() || sinks.empty()) {
+        throw std::runtime_error("Source or sink node not defined");
+    }
+}
+
+// Parses a binary CSR file (see csr.hpp) the same way, a chunk of arcs at a time
+template <typename Start, typename Arc>
+static void parse_csr(std::istream& in, Start start, Arc arc, std::vector<int>& sources, std::vector<int>& sinks) {
+    csr::Header header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        !std::equal(csr::magic, csr::magic + sizeof(csr::magic), header.magic)) {
+        throw std::runtime_error("Not a CSR graph file");
+    }
+    // Every arc becomes a pair of FlowState slots, indexed by int
+    if (header.n > static_cast<uint64_t>(std::numeric_limits<int>::max()) ||
+        header.m > static_cast<uint64_t>(std::numeric_limits<int>::max() / 2) ||
+        header.source >= header.n || header.sink >= header.n) {
+        throw std::runtime_error("CSR graph too large or malformed");
+    }
+    int n = static_cast<int>(header.n);
+    start(n, header.m);
 
+    std::vector<uint64_t> offsets(header.n + 1);
+    in.read(reinterpret_cast<char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    if (!in || offsets[0] != 0 || offsets[n] != header.m) {
+        throw std::runtime_error("Truncated or malformed CSR graph");
+    }
 
-    if (source == -1 || sink == -1) {
-        throw std::runtime_error("Source or sink node not defined");
+    // Heads and capacities are separate sections: read the heads, then pass the arcs
+    // on while reading the capacities in the same chunks
+    std::vector<uint32_t> heads(header.m);
+    in.read(reinterpret_cast<char*>(heads.data()), heads.size() * sizeof(uint32_t));
+
+    constexpr size_t chunk = 1 << 20;
+    std::vector<int32_t> capacities;
+    int u = 0;
+    for (uint64_t first = 0; first < header.m && in; first += chunk) {
+        capacities.resize(std::min<uint64_t>(chunk, header.m - first));
+        in.read(reinterpret_cast<char*>(capacities.data()), capacities.size() * sizeof(int32_t));
+        for (size_t i = 0; i < capacities.size(); ++i) {
+            uint64_t a = first + i;
+            while (offsets[u + 1] <= a) ++u;
+            if (heads[a] >= header.n) throw std::runtime_error("Arc head out of range in CSR graph");
+            arc(u, static_cast<int>(heads[a]), capacities[i]);
+        }
     }
+    if (!in) {
+        throw std::runtime_error("Truncated CSR graph");
+    }
+
+    sources = {static_cast<int>(header.source)};
+    sinks = {static_cast<int>(header.sink)};
+}
+
+template <typename Cap>
+void BasicGraph<Cap>::reserve_edges(size_t m) {
+    pending.reserve(m);
+}
+
+// Reads a graph in DIMACS max-flow format from an input stream
+template <typename Cap>
+void BasicGraph<Cap>::read_dimacs(std::istream& in) {
+    std::vector<int> input_sources, input_sinks;
+    parse_dimacs(
+        in, [this](int nodes, size_t edges) { *this = BasicGraph(nodes); reserve_edges(edges); },
+        [this](int from, int to, long long cap) { add_edge(from, to, static_cast<Cap>(cap)); }, input_sources,
+        input_sinks);
 
     compress_graph();
+    set_terminals(input_sources, input_sinks);
 
     // Imprime o grafo residual no terminal
     // print_residual_graph();
 }
 
+// Reads a graph in the binary CSR format of csr.hpp
+template <typename Cap>
+void BasicGraph<Cap>::read_csr(std::istream& in) {
+    std::vector<int> input_sources, input_sinks;
+    parse_csr(
+        in, [this](int nodes, size_t edges) { *this = BasicGraph(nodes); reserve_edges(edges); },
+        [this](int from, int to, long long cap) { add_edge(from, to, static_cast<Cap>(cap)); }, input_sources,
+        input_sinks);
 
-void Graph::compress_graph() {
-    // Mapa para armazenar capacidades de ida e volta entre pares (u, v)
-    std::map<std::pair<int, int>, int> forward_capacity;
+    compress_graph();
+    set_terminals(input_sources, input_sinks);
+}
 
-    for (int u = 0; u < n; ++u) {
-        for (const Edge& e : adj_list[u]) {
-            if (e.capacity > 0) {
-                forward_capacity[{u, e.to}] += e.capacity;
-            }
+// Arcs go into input.graph until a capacity, or the capacity around a vertex, needs
+// long long; the arcs recorded so far are then converted once into input.wide
+InputGraph read_graph(std::istream& in) {
+    InputGraph input;
+    std::vector<long long> around; // Capacity of the arcs in and out of each vertex
+    auto widen = [&input] {
+        input.wide = Graph64(input.graph);
+        input.graph = Graph();
+        input.is_wide = true;
+    };
+
+    auto start = [&](int nodes, size_t edges) {
+        input = InputGraph();
+        input.graph = Graph(nodes);
+        input.graph.reserve_edges(edges);
+        around.assign(nodes, 0);
+    };
+    auto arc = [&](int from, int to, long long capacity) {
+        if (capacity <= 0) return; // compress_graph drops them anyway
+        around[from] += capacity;
+        around[to] += capacity;
+        if (!input.is_wide && capacity > std::numeric_limits<int>::max()) widen();
+        if (input.is_wide) {
+            input.wide.add_edge(from, to, capacity);
+        } else {
+            input.graph.add_edge(from, to, static_cast<int>(capacity));
         }
-    }
-
-    // Nova lista de adjacência consolidada
-    std::vector<std::vector<Edge>> new_adj(n);
-    std::set<std::pair<int, int>> handled;
+    };
 
-    for (const auto& [pair, cap_uv] : forward_capacity) {
-        int u = pair.first;
-        int v = pair.second;
-
-        if (handled.count({u, v}) || handled.count({v, u})) continue;
-        handled.insert({u, v});
-        handled.insert({v, u});
+    std::vector<int> sources, sinks;
+    if (in.peek() == csr::magic[0]) {
+        parse_csr(in, start, arc, sources, sinks);
+    } else {
+        parse_dimacs(in, start, arc, sources, sinks);
+    }
 
-        int cap_uv_final = forward_capacity[{u, v}];
-        int cap_vu_final = forward_capacity[{v, u}];
+    // Same test as fits_in<int> on the finished graph. A super terminal (see set_terminals)
+    // gets an arc per terminal of at most the capacity around that terminal, which bounds
+    // the capacity around both.
+    long long limit = std::numeric_limits<int>::max();
+    bool fits = true;
+    for (long long c : around) {
+        if (c > limit) fits = false;
+    }
+    for (const std::vector<int>* terminals : {&sources, &sinks}) {
+        if (terminals->size() < 2) continue;
+        long long super = 0;
+        for (int v : *terminals) {
+            if (v < 0 || v >= static_cast<int>(around.size())) continue; // set_terminals reports it
+            super += around[v];
+            if (2 * around[v] > limit) fits = false;
+        }
+        if (super > limit) fits = false;
+    }
+    if (!input.is_wide && !fits) widen();
+
+    if (input.is_wide) {
+        input.wide.compress_graph();
+        input.wide.set_terminals(sources, sinks);
+    } else {
+        input.graph.compress_graph();
+        input.graph.set_terminals(sources, sinks);
+    }
+    return input;
+}
 
-        // Criação de uma nova aresta forward (u → v)
-        int fid = next_edge_id_aux++; // Cria um novo fid
 
-        // u → v (forward)
-        Edge forward = {fid, v, u, static_cast<int>(new_adj[v].size()), cap_uv_final, 0};
-        new_adj[u].push_back(forward);
+// Builds the arc block from the recorded arcs (and any already in the lists).
+// Parallel arcs are merged and u -> v is paired with v -> u. Pairs are created in
+// (tail, head) order of the first of their two arcs, so each list is sorted by
+// neighbour within the pairs it starts and within the pairs it closes.
+template <typename Cap>
+void BasicGraph<Cap>::compress_graph() {
+    std::vector<InputArc> input;
+    input.swap(pending);
+    input.erase(std::remove_if(input.begin(), input.end(), [](const InputArc& a) { return a.capacity <= 0; }),
+                input.end());
+    for (int u = 0; u < n; ++u) {
+        for (const Edge& e : adj(u)) {
+            if (e.capacity > 0) input.push_back({u, e.to, e.capacity});
+        }
+    }
 
-        // v → u (reverse)
-        Edge backward = {-1, u, v, static_cast<int>(new_adj[u].size()) - 1, cap_vu_final, 0};
-        new_adj[v].push_back(backward);
+    // Two stable counting sorts, by head and then by tail, order the arcs by (tail, head)
+    std::vector<size_t> first(n + 1);
+    auto counting_sort = [&](const std::vector<InputArc>& from, std::vector<InputArc>& to, bool by_tail) {
+        std::fill(first.begin(), first.end(), 0);
+        for (const InputArc& a : from) ++first[(by_tail ? a.from : a.to) + 1];
+        for (int v = 0; v < n; ++v) first[v + 1] += first[v];
+        std::vector<size_t> next(first.begin(), first.end() - 1);
+        for (const InputArc& a : from) to[next[by_tail ? a.from : a.to]++] = a;
+    };
+    std::vector<InputArc> by_head(input.size());
+    counting_sort(input, by_head, false);
+    counting_sort(by_head, input, true);
+    by_head = {};
+
+    // Parallel arcs are now adjacent: add up their capacities
+    size_t unique = 0;
+    for (size_t i = 0; i < input.size(); ++i) {
+        if (unique > 0 && input[unique - 1].from == input[i].from && input[unique - 1].to == input[i].to) {
+            input[unique - 1].capacity += input[i].capacity;
+        } else {
+            input[unique++] = input[i];
+        }
+    }
+    input.resize(unique);
+
+    std::fill(first.begin(), first.end(), 0);
+    for (const InputArc& a : input) ++first[a.from + 1];
+    for (int v = 0; v < n; ++v) first[v + 1] += first[v];
+
+    // Capacity of u -> v, 0 if there is no such arc
+    auto capacity_of = [&](int u, int v) -> Cap {
+        auto begin = input.begin() + first[u], end = input.begin() + first[u + 1];
+        auto it = std::lower_bound(begin, end, v, [](const InputArc& a, int head) { return a.to < head; });
+        return (it != end && it->to == v) ? it->capacity : 0;
+    };
+    // v -> u was paired when v -> u came first
+    auto starts_pair = [&](const InputArc& a) {
+        return a.to >= a.from || capacity_of(a.to, a.from) == 0;
+    };
+
+    // First pass: degrees, so every list gets its final place in one block
+    numa::allocate_interleaved(lists, n);
+    size_t total = 0;
+    for (const InputArc& a : input) {
+        if (!starts_pair(a)) continue;
+        ++lists[a.from].degree;
+        ++lists[a.to].degree;
+    }
+    for (ArcList& l : lists) {
+        l.first = total;
+        l.room = l.degree;
+        total += l.degree;
+        l.degree = 0;
+    }
+    numa::allocate_interleaved(arcs, total);
+
+    // Second pass: the pairs, with flow slots renumbered in creation order
+    next_arc = 0;
+    for (const InputArc& a : input) {
+        if (!starts_pair(a)) continue;
+        int u = a.from, v = a.to;
+        int iu = lists[u].degree++;
+        int iv = lists[v].degree++;
+        arcs[lists[u].first + iu] = {v, iv, next_arc++, a.capacity};            // u → v (forward)
+        arcs[lists[v].first + iv] = {u, iu, next_arc++, capacity_of(v, u)};     // v → u (reverse)
     }
+}
 
-    adj_list = std::move(new_adj);
+// Turns every merged pair into an undirected edge: both directions get the
+// capacity of u -> v plus the capacity of v -> u.
+template <typename Cap>
+void BasicGraph<Cap>::make_undirected() {
+    for (int u = 0; u < n; ++u) {
+        Edge* neighbors = list(u);
+        for (int i = 0; i < lists[u].degree; ++i) {
+            Edge& e = neighbors[i];
+            if (!e.is_forward()) continue; // handle each pair once, from its forward half
+            Edge& r = list(e.to)[e.rev];
+            Cap cap = e.capacity + r.capacity;
+            e.capacity = cap;
+            r.capacity = cap;
+        }
+    }
 }
 
-// Imprime o grafo residual no terminal
-void Graph::print_residual_graph() const {
-    std::cout << "Residual Graph:\n";
+// compress_graph creates each pair when its first arc comes up in (tail, head)
+// order, so a list gets u -> v with v < u after its higher neighbours whenever
+// only u -> v exists. Sorting every list fixes that; the reverse halves follow
+// through the new position of each arc in its list.
+template <typename Cap>
+void BasicGraph<Cap>::sort_arc_lists() {
+    std::vector<int> position(arcs.size());
+    std::vector<std::vector<int>> orders(n);
+    for (int u = 0; u < n; ++u) {
+        const Edge* neighbors = list(u);
+        std::vector<int>& order = orders[u];
+        order.resize(lists[u].degree);
+        for (int i = 0; i < lists[u].degree; ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return neighbors[a].to < neighbors[b].to; });
+        for (int i = 0; i < lists[u].degree; ++i) position[lists[u].first + order[i]] = i;
+    }
 
+    std::vector<Edge> old;
     for (int u = 0; u < n; ++u) {
-        for (const Edge& e : adj_list[u]) {
-            // Mostra todas as arestas, inclusive reversas
-            std::cout << "  " << u << " -> " << e.to
-                      << " | cap: " << e.capacity
-                      << " | flow: " << e.flow
-                      << " | residual: " << (e.capacity - e.flow)
-                      << "\n";
+        Edge* neighbors = list(u);
+        old.assign(neighbors, neighbors + lists[u].degree);
+        for (int i = 0; i < lists[u].degree; ++i) {
+            neighbors[i] = old[orders[u][i]];
+            neighbors[i].rev = position[lists[neighbors[i].to].first + neighbors[i].rev];
         }
     }
-}
\ No newline at end of file
+}
+
+template class BasicGraph<int>;
+template class BasicGraph<long long>;
+template BasicGraph<int>::BasicGraph(const BasicGraph<long long>&);
+template BasicGraph<long long>::BasicGraph(const BasicGraph<int>&);
@@ -0,0 +1,82 @@
+#include "huge_pages.hpp"
+#include <new>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace huge_pages {
+
+namespace {
+    Mode current_mode = Mode::Default;
+
+    size_t round_up(size_t bytes) {
+        return (bytes + page_size - 1) / page_size * page_size;
+    }
+} // namespace
+
+void set_mode(Mode mode) {
+    current_mode = mode;
+}
+
+Mode mode() {
+    return current_mode;
+}
+
+Mode parse_mode(const std::string& name) {
+    if (name == "off") return Mode::Off;
+    if (name == "thp") return Mode::Transparent;
+    if (name == "explicit") return Mode::Explicit;
+    throw std::runtime_error("Unknown huge page mode: " + name);
+}
+
+#ifdef __linux__
+
+void* allocate(size_t bytes) {
+    if (bytes < page_size) return ::operator new(bytes);
+    size_t length = round_up(bytes);
+
+    if (current_mode == Mode::Explicit) {
+        void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) return p;
+    }
+
+    // Map one huge page more than needed and trim both ends to a 2 MB boundary
+    char* raw = static_cast<char*>(mmap(nullptr, length + page_size, PROT_READ | PROT_WRITE,
+                                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (raw == MAP_FAILED) throw std::bad_alloc();
+    size_t head = (page_size - reinterpret_cast<size_t>(raw) % page_size) % page_size;
+    if (head > 0) munmap(raw, head);
+    munmap(raw + head + length, page_size - head);
+    char* p = raw + head;
+
+    if (current_mode == Mode::Transparent || current_mode == Mode::Explicit) {
+        madvise(p, length, MADV_HUGEPAGE);
+    } else if (current_mode == Mode::Off) {
+        madvise(p, length, MADV_NOHUGEPAGE);
+    }
+    return p;
+}
+
+void deallocate(void* p, size_t bytes) {
+    if (bytes < page_size) {
+        ::operator delete(p);
+        return;
+    }
+    munmap(p, round_up(bytes));
+}
+
+#else
+
+void* allocate(size_t bytes) {
+    return ::operator new(bytes);
+}
+
+void deallocate(void* p, size_t) {
+    ::operator delete(p);
+}
+
+#endif
+
+} // namespace huge_pages
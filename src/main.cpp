@@ -5,61 +5,289 @@
 #include "find_path_headers/dfs_random.hpp"
 #include "find_path_headers/fattest.hpp"
 #include "find_path_headers/capacity_scaling.hpp"
+#include "min_cut.hpp"
+#include "flow_decomposition.hpp"
+#include "gomory_hu.hpp"
+#include "batch.hpp"
+#include "portfolio.hpp"
+#include "solver_selection.hpp"
+#include "thread_pool.hpp"
+#include "parallel_bfs.hpp"
+#include "prune.hpp"
+#include "reduce.hpp"
+#include "reorder.hpp"
+#include "huge_pages.hpp"
+#include "numa.hpp"
+#include "csr.hpp"
 
 
+#include <algorithm>
 #include <iostream>
+#include <fstream>
 #include <string>
+#include <stdexcept>
 
-int main(int argc, char* argv[]) {
-    bool is_ford_fulkerson = true;
-
-    if (argc < 2) {
-        std::cerr << "Uso: " << argv[0] << " bfs|dfs|fat|scaling|dinics < dimacs_graph\n";
-        return 1;
-    }
-
-    std::string strategy_name = argv[1];
-    PathFindingStrategy strategy = nullptr;
-    AlgorithmType type;
-
-    if (strategy_name == "bfs") {
-        strategy = bfs_path;
+// Maps a strategy name to its path-finding routine; false for an unknown name
+template <typename Cap>
+static bool select_algorithm(const std::string& name, BasicPathFindingStrategy<Cap>& strategy, AlgorithmType& type, bool& is_ford_fulkerson) {
+    is_ford_fulkerson = true;
+    if (name == "bfs") {
+        strategy = bfs_path<Cap>;
         type = AlgorithmType::BFS_EDMONDS_KARP;
-    } else if (strategy_name == "dfs") {
-        strategy = dfs_path;
+    } else if (name == "dfs") {
+        strategy = dfs_path<Cap>;
         type = AlgorithmType::DFS_RANDOM;
-    } else if (strategy_name == "fat") {
-        strategy = fattest_path;
+    } else if (name == "fat") {
+        strategy = fattest_path<Cap>;
         type = AlgorithmType::FATTEST_PATH;
-    } else if (strategy_name == "scaling") {
-        strategy = capacity_scaling_path;
+    } else if (name == "scaling") {
+        strategy = capacity_scaling_path<Cap>;
         type = AlgorithmType::CAPACITY_SCALING;
-    } else if (strategy_name == "dinics") {
+    } else if (name == "dinics") {
         is_ford_fulkerson = false;
-        //strategy = dinics_path;
-        //std::cerr << "Ainda não implementado dinics\n";
     } else {
-        std::cerr << "Estrategia inválida: " << strategy_name << ". Use bfs ou dfs.\n";
-        return 1;
+        return false;
+    }
+    return true;
+}
+
+// Command line options, parsed before the graph is read
+struct Options {
+    std::string strategy_name;
+    std::string cut_file;
+    std::string paths_file;
+    std::string gomory_hu_file;
+    std::string batch_file;
+    std::string order_name;
+    int threads = 1;                                     // BFS workers of a single solve (--threads k)
+    int pool_threads = thread_pool::default_workers();  // Batch and Gomory-Hu workers (--threads k too)
+    bool prune = false;                                  // --prune: drop what is on no s-t path
+    bool reduce = false;                                 // --reduce: contract series chains and parallel arcs
+    bool is_portfolio = false;
+    bool is_auto = false;
+};
+
+// Everything after loading, with capacities and flows held in Cap
+template <typename Cap>
+static int run(const BasicGraph<Cap>& graph, Options options) {
+    using Graph = BasicGraph<Cap>;
+    using FlowState = BasicFlowState<Cap>;
+
+    bool is_ford_fulkerson = !options.is_portfolio;
+    BasicPathFindingStrategy<Cap> strategy = nullptr;
+    AlgorithmType type = AlgorithmType::BFS_EDMONDS_KARP;
+    std::string& strategy_name = options.strategy_name;
+    if (!options.is_portfolio && !options.is_auto) {
+        select_algorithm(strategy_name, strategy, type, is_ford_fulkerson);
     }
 
-    Graph graph;
-    graph.read_dimacs(std::cin);
+    // With --prune the s-t solve only gets the vertices on some s-t path (batch queries need them all)
+    BasicPrunedGraph<Cap> pruned;
+    bool is_pruned = options.prune && options.batch_file.empty() && prune_graph(graph, pruned);
+    const Graph& pruned_graph = is_pruned ? pruned.graph : graph;
+
+    // With --reduce, chains and parallel arcs are contracted next
+    BasicReducedGraph<Cap> reduced;
+    bool is_reduced = options.reduce && options.batch_file.empty() && reduce_graph(pruned_graph, reduced);
+    const Graph& reduced_graph = is_reduced ? reduced.graph : pruned_graph;
+
+    // Optionally relabel the vertices for locality
+    BasicPrunedGraph<Cap> reordered;
+    bool is_reordered = options.batch_file.empty() && !options.order_name.empty();
+    if (is_reordered) {
+        reordered = reorder_graph(reduced_graph, parse_vertex_order(options.order_name));
+    }
+    const Graph& solve_graph = is_reordered ? reordered.graph : reduced_graph;
+
+    // auto: pick the strategy from cheap features of the instance
+    if (options.is_auto) {
+        InstanceFeatures features = compute_features(solve_graph, solve_graph.get_source(), solve_graph.get_sink());
+        strategy_name = select_strategy(features);
+        select_algorithm(strategy_name, strategy, type, is_ford_fulkerson);
+        std::cerr << "auto: " << strategy_name << "\n";
+    }
+
+    // Batch mode: one graph, many (s, t) pairs, results streamed in order
+    if (!options.batch_file.empty()) {
+        std::ifstream queries_in(options.batch_file);
+        if (!queries_in) {
+            std::cerr << "Nao foi possivel abrir " << options.batch_file << "\n";
+            return 1;
+        }
+        std::vector<STQuery> queries = read_queries(queries_in, graph.num_input_vertices());
+        solve_batch(graph, queries, make_solver<Cap>(strategy_name), options.pool_threads, std::cout);
+        return 0;
+    }
 
     int source = graph.get_source();
     int sink = graph.get_sink();
-    int max_flow = -3;
+    Cap max_flow = -3;
+
+    int solve_source = solve_graph.get_source();
+    int solve_sink = solve_graph.get_sink();
 
     FFStats stats;
+    FlowState flow(graph);
+    FlowState solve_flow(solve_graph);
+    std::vector<char> source_side;
 
-    if(is_ford_fulkerson){
-        max_flow = ford_fulkerson(graph, source, sink, strategy, type, &stats);
+    if(options.is_portfolio){
+        BasicPortfolioResult<Cap> result = solve_portfolio(solve_graph, solve_source, solve_sink);
+        max_flow = result.max_flow;
+        solve_flow = std::move(result.flow);
+        std::cerr << "portfolio winner: " << result.winner << "\n";
     }else{
-        max_flow = dinic_max_flow(graph, source, sink);
+        // A single solve: its BFS searches get the options.threads
+        parallel_bfs::set_workers(options.threads);
+        if(is_ford_fulkerson){
+            max_flow = ford_fulkerson(solve_graph, solve_flow, solve_source, solve_sink, strategy, type, &stats);
+        }else{
+            // Dinic's cut side is only usable as is on the input graph
+            bool want_side = !options.cut_file.empty() && !is_pruned && !is_reduced && !is_reordered;
+            max_flow = dinic_max_flow(solve_graph, solve_flow, solve_source, solve_sink, want_side ? &source_side : nullptr);
+        }
+        parallel_bfs::set_workers(1); // the Gomory-Hu flows run in parallel themselves
+    }
+
+    // Cuts and paths are written on the input graph
+    if (is_reordered) {
+        FlowState reduced_flow(reduced_graph);
+        map_flow_back(reduced_graph, reordered, solve_flow, reduced_flow);
+        solve_flow = std::move(reduced_flow);
+    }
+    if (is_reduced) {
+        FlowState pruned_flow(pruned_graph);
+        map_flow_back(pruned_graph, reduced, solve_flow, pruned_flow);
+        solve_flow = std::move(pruned_flow);
+    }
+    if (is_pruned) {
+        map_flow_back(graph, pruned, solve_flow, flow);
+    } else {
+        flow = std::move(solve_flow);
     }
 
 
     std::cout << max_flow << "\n";
 
+    if (!options.cut_file.empty()) {
+        BasicMinCut<Cap> cut = source_side.empty() ? min_cut(graph, flow, source)
+                                         : min_cut_from_side(graph, std::move(source_side));
+        std::ofstream out(options.cut_file);
+        if (!out) {
+            std::cerr << "Nao foi possivel abrir " << options.cut_file << "\n";
+            return 1;
+        }
+        write_cut(graph, cut, out);
+    }
+
+    if (!options.paths_file.empty()) {
+        std::ofstream out(options.paths_file);
+        if (!out) {
+            std::cerr << "Nao foi possivel abrir " << options.paths_file << "\n";
+            return 1;
+        }
+        write_flow_decomposition(graph, flow, source, sink, out);
+    }
+
+    if (!options.gomory_hu_file.empty()) {
+        // Same strategy for each of the n-1 flows of the tree
+        BasicGomoryHuTree<Cap> tree = gomory_hu_tree(graph, make_solver<Cap>(strategy_name), options.pool_threads);
+        std::ofstream out(options.gomory_hu_file);
+        if (!out) {
+            std::cerr << "Nao foi possivel abrir " << options.gomory_hu_file << "\n";
+            return 1;
+        }
+        write_gomory_hu_tree(tree, out);
+    }
+
     return 0;
-}
\ No newline at end of file
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Uso: " << argv[0] << " bfs|dfs|fat|scaling|dinics|portfolio|auto [--cut arquivo] [--paths arquivo] [--gomory-hu arquivo] [--batch pares] [--threads k] [--prune] [--reduce] [--order bfs|rcm] [--huge-pages off|thp|explicit] [--numa] < dimacs_graph\n";
+        return 1;
+    }
+
+    // Optional outputs
+    Options options;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--cut" && i + 1 < argc) {
+            options.cut_file = argv[++i];
+        } else if (arg == "--paths" && i + 1 < argc) {
+            options.paths_file = argv[++i];
+        } else if (arg == "--gomory-hu" && i + 1 < argc) {
+            options.gomory_hu_file = argv[++i];
+        } else if (arg == "--batch" && i + 1 < argc) {
+            options.batch_file = argv[++i];
+        } else if (arg == "--prune") {
+            options.prune = true;
+        } else if (arg == "--reduce") {
+            options.reduce = true;
+        } else if (arg == "--order" && i + 1 < argc) {
+            options.order_name = argv[++i];
+            if (options.order_name != "bfs" && options.order_name != "rcm") {
+                std::cerr << "Ordem inválida: " << options.order_name << ". Use bfs ou rcm.\n";
+                return 1;
+            }
+        } else if (arg == "--huge-pages" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode != "off" && mode != "thp" && mode != "explicit") {
+                std::cerr << "Modo de huge pages inválido: " << mode << ". Use off, thp ou explicit.\n";
+                return 1;
+            }
+            huge_pages::set_mode(huge_pages::parse_mode(mode));
+        } else if (arg == "--numa") {
+            numa::set_interleave(true);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            std::string value = argv[++i];
+            size_t end = 0;
+            int threads = 0;
+            try {
+                threads = std::stoi(value, &end);
+            } catch (const std::logic_error&) {
+            }
+            if (threads < 1 || end != value.size()) {
+                std::cerr << "Opcao inválida: --threads " << value << ". Use um inteiro positivo.\n";
+                return 1;
+            }
+            // More threads than the hardware runs at once only add synchronization
+            // (see BM_dinic_threads in micro_bench), so --threads is capped there
+            threads = std::min(threads, thread_pool::default_workers());
+            options.threads = threads;
+            options.pool_threads = threads;
+        } else {
+            std::cerr << "Opcao inválida: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    // The name is only checked here, run() selects the strategy for its capacity type
+    options.strategy_name = argv[1];
+    PathFindingStrategy strategy = nullptr;
+    AlgorithmType type = AlgorithmType::BFS_EDMONDS_KARP;
+    bool is_ford_fulkerson = true;
+    options.is_auto = (options.strategy_name == "auto");
+
+    if (options.strategy_name == "portfolio") {
+        // Races all strategies on separate threads, the first to finish answers
+        options.is_portfolio = true;
+    } else if (!options.is_auto && !select_algorithm(options.strategy_name, strategy, type, is_ford_fulkerson)) {
+        std::cerr << "Estrategia inválida: " << options.strategy_name << ". Use bfs ou dfs.\n";
+        return 1;
+    }
+
+    if (options.is_portfolio && (!options.batch_file.empty() || !options.gomory_hu_file.empty())) {
+        std::cerr << "portfolio nao pode ser usado com --batch ou --gomory-hu\n";
+        return 1;
+    }
+
+    // The solve runs on int unless some flow could overflow it (see read_graph).
+    // The input is DIMACS text or a binary CSR file (from bin/gengraph_parallel).
+    InputGraph input = read_graph(std::cin);
+    if (input.is_wide) {
+        return run(input.wide, options);
+    }
+    return run(input.graph, options);
+}
@@ -0,0 +1,33 @@
+#include "max_flow_solver.hpp"
+#include "ford_fulkerson.hpp"
+#include "dinics.hpp"
+#include "find_path_headers/bfs.hpp"
+#include "find_path_headers/dfs_random.hpp"
+#include "find_path_headers/fattest.hpp"
+#include "find_path_headers/capacity_scaling.hpp"
+
+// Wraps a Ford-Fulkerson strategy, stats are collected per call and dropped
+template <typename Cap>
+static BasicMaxFlowSolver<Cap> ford_fulkerson_solver(BasicPathFindingStrategy<Cap> strategy, AlgorithmType type, const std::atomic<bool>* cancel) {
+    return [strategy, type, cancel](const BasicGraph<Cap>& graph, BasicFlowState<Cap>& flow, int s, int t) {
+        FFStats stats;
+        return ford_fulkerson(graph, flow, s, t, strategy, type, &stats, cancel);
+    };
+}
+
+template <typename Cap>
+BasicMaxFlowSolver<Cap> make_solver(const std::string& name, const std::atomic<bool>* cancel) {
+    if (name == "bfs") return ford_fulkerson_solver<Cap>(bfs_path<Cap>, AlgorithmType::BFS_EDMONDS_KARP, cancel);
+    if (name == "dfs") return ford_fulkerson_solver<Cap>(dfs_path<Cap>, AlgorithmType::DFS_RANDOM, cancel);
+    if (name == "fat") return ford_fulkerson_solver<Cap>(fattest_path<Cap>, AlgorithmType::FATTEST_PATH, cancel);
+    if (name == "scaling") return ford_fulkerson_solver<Cap>(capacity_scaling_path<Cap>, AlgorithmType::CAPACITY_SCALING, cancel);
+    if (name == "dinics") {
+        return [cancel](const BasicGraph<Cap>& graph, BasicFlowState<Cap>& flow, int s, int t) {
+            return dinic_max_flow(graph, flow, s, t, nullptr, cancel);
+        };
+    }
+    return nullptr;
+}
+
+template MaxFlowSolver make_solver(const std::string&, const std::atomic<bool>*);
+template BasicMaxFlowSolver<long long> make_solver(const std::string&, const std::atomic<bool>*);
@@ -0,0 +1,84 @@
+#include "min_cut.hpp"
+#include <queue>
+
+template <typename Cap>
+std::vector<char> residual_source_side(const BasicGraph<Cap>& graph, const BasicFlowState<Cap>& flow, int s) {
+    using Edge = BasicEdge<Cap>;
+    std::vector<char> side(graph.size(), 0);
+    std::queue<int> q;
+    side[s] = 1;
+    q.push(s);
+
+    // Plain BFS over arcs with residual capacity
+    while (!q.empty()) {
+        int u = q.front();
+        q.pop();
+        for (const Edge& e : graph.get_neighbors(u)) {
+            if (!side[e.to] && flow.remaining_capacity(e) > 0) {
+                side[e.to] = 1;
+                q.push(e.to);
+            }
+        }
+    }
+
+    return side;
+}
+
+template <typename Cap>
+BasicMinCut<Cap> min_cut(const BasicGraph<Cap>& graph, const BasicFlowState<Cap>& flow, int s) {
+    return min_cut_from_side(graph, residual_source_side(graph, flow, s));
+}
+
+template <typename Cap>
+BasicMinCut<Cap> min_cut_from_side(const BasicGraph<Cap>& graph, std::vector<char> source_side) {
+    using Edge = BasicEdge<Cap>;
+    BasicMinCut<Cap> cut;
+    cut.source_side = std::move(source_side);
+
+    // With terminal sets, a saturated super-terminal arc can be swapped for the
+    // terminal's own arcs without increasing the cut, so the cut only uses input arcs
+    for (int v : graph.get_sources()) cut.source_side[v] = 1;
+    for (int v : graph.get_sinks()) cut.source_side[v] = 0;
+
+    for (int u = 0; u < graph.size(); ++u) {
+        if (!cut.source_side[u]) continue;
+        const auto& neighbors = graph.get_neighbors(u);
+        for (size_t i = 0; i < neighbors.size(); ++i) {
+            const Edge& e = neighbors[i];
+            // Reverse halves of merged pairs only count if they carry capacity of their own
+            if (!cut.source_side[e.to] && e.capacity > 0) {
+                cut.arcs.push_back({u, static_cast<int>(i)});
+                cut.capacity += e.capacity;
+            }
+        }
+    }
+
+    return cut;
+}
+
+template <typename Cap>
+void write_cut(const BasicGraph<Cap>& graph, const BasicMinCut<Cap>& cut, std::ostream& out) {
+    using Edge = BasicEdge<Cap>;
+    // Super terminals are not part of the input, leave them out
+    int input_n = graph.num_input_vertices();
+    int side_size = 0;
+    for (int v = 0; v < input_n; ++v) side_size += cut.source_side[v];
+
+    out << "p cut " << cut.capacity << " " << side_size << " " << cut.arcs.size() << "\n";
+    for (int v = 0; v < input_n; ++v) {
+        if (cut.source_side[v]) out << "n " << v + 1 << " s\n";
+    }
+    for (const auto& [u, idx] : cut.arcs) {
+        const Edge& e = graph.adj(u)[idx];
+        out << "a " << u + 1 << " " << e.to + 1 << " " << e.capacity << "\n";
+    }
+}
+
+template std::vector<char> residual_source_side(const Graph&, const FlowState&, int);
+template std::vector<char> residual_source_side(const Graph64&, const FlowState64&, int);
+template MinCut min_cut(const Graph&, const FlowState&, int);
+template MinCut64 min_cut(const Graph64&, const FlowState64&, int);
+template MinCut min_cut_from_side(const Graph&, std::vector<char>);
+template MinCut64 min_cut_from_side(const Graph64&, std::vector<char>);
+template void write_cut(const Graph&, const MinCut&, std::ostream&);
+template void write_cut(const Graph64&, const MinCut64&, std::ostream&);
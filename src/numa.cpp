@@ -0,0 +1,106 @@
+#include "numa.hpp"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace numa {
+
+namespace {
+    bool enabled = false;
+    thread_local bool pinned = false; // Set by pin_worker on the calling thread
+
+    // Parses a sysfs list such as "0-3,8-11"
+    std::vector<int> read_list(const std::string& path) {
+        std::vector<int> values;
+        std::ifstream in(path);
+        std::string item;
+        while (std::getline(in, item, ',')) {
+            int first, last;
+            char dash;
+            std::istringstream range(item);
+            if (!(range >> first)) continue;
+            last = (range >> dash >> last) ? last : first;
+            for (int v = first; v <= last; ++v) values.push_back(v);
+        }
+        return values;
+    }
+
+    const std::vector<int>& nodes() {
+        static const std::vector<int> online = [] {
+            std::vector<int> list = read_list("/sys/devices/system/node/online");
+            return list.empty() ? std::vector<int>{0} : list;
+        }();
+        return online;
+    }
+
+    // CPUs of each online node, in the order of nodes()
+    const std::vector<std::vector<int>>& node_cpus() {
+        static const std::vector<std::vector<int>> cpus = [] {
+            std::vector<std::vector<int>> lists;
+            for (int node : nodes()) {
+                lists.push_back(read_list("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"));
+            }
+            return lists;
+        }();
+        return cpus;
+    }
+} // namespace
+
+void set_interleave(bool value) {
+    enabled = value;
+}
+
+bool interleave_enabled() {
+    return enabled;
+}
+
+int num_nodes() {
+    return static_cast<int>(nodes().size());
+}
+
+#ifdef __linux__
+
+void interleave(void* p, size_t bytes) {
+    if (!enabled || pinned || num_nodes() < 2 || bytes == 0) return;
+
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t begin = (reinterpret_cast<size_t>(p) + page - 1) / page * page;
+    size_t end = (reinterpret_cast<size_t>(p) + bytes) / page * page;
+    if (begin >= end) return;
+
+    constexpr int bits = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> mask(nodes().back() / bits + 1, 0);
+    for (int node : nodes()) mask[node / bits] |= 1UL << (node % bits);
+
+    // Best effort: a failure only leaves the default first-touch placement
+    syscall(SYS_mbind, begin, end - begin, MPOL_INTERLEAVE, mask.data(), mask.size() * bits, 0);
+}
+
+void pin_worker(int worker) {
+    if (!enabled || num_nodes() < 2) return;
+
+    const std::vector<int>& cpus = node_cpus()[worker % num_nodes()];
+    if (cpus.empty()) return;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) CPU_SET(cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) == 0) pinned = true;
+}
+
+#else
+
+void interleave(void*, size_t) {}
+void pin_worker(int) {}
+
+#endif
+
+} // namespace numa
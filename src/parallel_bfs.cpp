@@ -0,0 +1,213 @@
+#include "parallel_bfs.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace parallel_bfs {
+
+namespace {
+    int bfs_workers = 1;
+
+    // Visited tokens shared by the workers of one search and claimed with a CAS.
+    // One array per calling thread, so independent solves still run concurrently.
+    using VisitedArray = std::vector<std::atomic<uint64_t>, huge_pages::Allocator<std::atomic<uint64_t>>>;
+    thread_local VisitedArray visited;
+    thread_local uint64_t visited_token = 0;
+
+    constexpr int top_down_chunk = 64;    // frontier vertices taken per grab
+    constexpr int bottom_up_chunk = 1024; // vertices taken per grab
+
+    // Reusable barrier between the steps of a search (C++17 has no std::barrier)
+    class Barrier {
+    public:
+        explicit Barrier(int count) : count(count) {}
+
+        void wait() {
+            std::unique_lock<std::mutex> lock(mutex);
+            int gen = generation;
+            if (++arrived == count) {
+                arrived = 0;
+                ++generation;
+                cv.notify_all();
+            } else {
+                cv.wait(lock, [&] { return gen != generation; });
+            }
+        }
+
+    private:
+        std::mutex mutex;
+        std::condition_variable cv;
+        int count;
+        int arrived = 0;
+        int generation = 0;
+    };
+} // namespace
+
+void set_workers(int workers) {
+    bfs_workers = std::max(1, workers);
+}
+
+int workers() {
+    return bfs_workers;
+}
+
+template <typename Cap>
+bool search(const BasicGraph<Cap>& graph, const BasicFlowState<Cap>& flow, int s, int t, int workers,
+            std::vector<int>& level, std::vector<std::pair<int, int>>* parent, Counters* counters, bool reverse) {
+    using Edge = BasicEdge<Cap>;
+    int n = graph.size();
+    workers = std::max(1, workers);
+
+    if (visited.size() < static_cast<size_t>(n)) {
+        VisitedArray fresh(n);
+        visited.swap(fresh);
+        visited_token = 0;
+    }
+    const uint64_t token = ++visited_token;
+    VisitedArray& vis = visited; // the workers are other threads
+
+    // Residual capacity from x to e.to, for an arc e of adj(x), in the direction searched
+    auto residual = [&](const Edge& e) {
+        return reverse ? flow.remaining_capacity(graph.adj(e.to)[e.rev]) : flow.remaining_capacity(e);
+    };
+    // Residual capacity from e.to to x, for an arc e of adj(x)
+    auto residual_in = [&](const Edge& e) {
+        return reverse ? flow.remaining_capacity(e) : flow.remaining_capacity(graph.adj(e.to)[e.rev]);
+    };
+
+    level.assign(n, -1);
+    if (parent) parent->assign(n, {-1, -1});
+    level[s] = 0;
+    vis[s].store(token, std::memory_order_relaxed);
+
+    std::vector<int> frontier = {s};
+    std::vector<std::vector<int>> next(workers);
+    std::vector<Counters> partial(workers);
+    std::vector<char> in_frontier;     // frontier bitmap, only built for bottom-up steps
+    std::atomic<int> cursor{0};
+    Barrier barrier(workers);
+
+    int depth = 0;
+    bool bottom_up = false;
+    bool done = (s == t);
+    long long unexplored = graph.num_edges_residual() - static_cast<long long>(graph.adj(s).size());
+    partial[0].visited_nodes = 1;
+
+    // Runs on worker 0 between two steps: gathers the new frontier and picks the direction
+    auto advance = [&] {
+        if (bottom_up) {
+            for (int u : frontier) in_frontier[u] = 0;
+        }
+
+        frontier.clear();
+        long long frontier_arcs = 0;
+        for (auto& list : next) {
+            for (int v : list) {
+                frontier.push_back(v);
+                frontier_arcs += graph.adj(v).size();
+            }
+            list.clear();
+        }
+        unexplored -= frontier_arcs;
+        partial[0].visited_nodes += frontier.size();
+        ++depth;
+        cursor.store(0, std::memory_order_relaxed);
+
+        if (frontier.empty() || vis[t].load(std::memory_order_relaxed) == token) {
+            done = true;
+            return;
+        }
+
+        if (!bottom_up && frontier_arcs > unexplored / alpha) {
+            bottom_up = true;
+        } else if (bottom_up && static_cast<long long>(frontier.size()) * beta < n) {
+            bottom_up = false;
+        }
+        if (bottom_up) {
+            if (in_frontier.empty()) in_frontier.assign(n, 0);
+            for (int u : frontier) in_frontier[u] = 1;
+        }
+    };
+
+    thread_pool::run(workers, [&](int w) {
+        std::vector<int>& out = next[w];
+        Counters& c = partial[w];
+
+        while (true) {
+            barrier.wait();
+            if (done) break;
+
+            if (!bottom_up) {
+                // Top-down: frontier vertices claim their unvisited residual successors
+                int size = static_cast<int>(frontier.size());
+                int begin;
+                while ((begin = cursor.fetch_add(top_down_chunk, std::memory_order_relaxed)) < size) {
+                    int end = std::min(size, begin + top_down_chunk);
+                    for (int k = begin; k < end; ++k) {
+                        int u = frontier[k];
+                        const auto& neighbors = graph.adj(u);
+                        for (size_t i = 0; i < neighbors.size(); ++i) {
+                            const Edge& e = neighbors[i];
+                            if (e.capacity > 0) ++c.forward_arcs;
+                            ++c.residual_arcs;
+                            if (residual(e) <= 0) continue;
+
+                            uint64_t seen = vis[e.to].load(std::memory_order_relaxed);
+                            if (seen == token) continue;
+                            if (!vis[e.to].compare_exchange_strong(seen, token, std::memory_order_relaxed)) continue;
+
+                            level[e.to] = depth + 1;
+                            if (parent) (*parent)[e.to] = {u, static_cast<int>(i)};
+                            out.push_back(e.to);
+                        }
+                    }
+                }
+            } else {
+                // Bottom-up: each unvisited vertex looks for a frontier vertex with a residual arc into it.
+                // Every vertex is owned by the worker that grabbed it, so no CAS is needed.
+                int begin;
+                while ((begin = cursor.fetch_add(bottom_up_chunk, std::memory_order_relaxed)) < n) {
+                    int end = std::min(n, begin + bottom_up_chunk);
+                    for (int v = begin; v < end; ++v) {
+                        if (vis[v].load(std::memory_order_relaxed) == token) continue;
+                        for (const Edge& e : graph.adj(v)) {
+                            ++c.residual_arcs;
+                            if (!in_frontier[e.to]) continue;
+                            if (graph.adj(e.to)[e.rev].capacity > 0) ++c.forward_arcs;
+                            if (residual_in(e) <= 0) continue;
+
+                            vis[v].store(token, std::memory_order_relaxed);
+                            level[v] = depth + 1;
+                            if (parent) (*parent)[v] = {e.to, e.rev};
+                            out.push_back(v);
+                            break;
+                        }
+                    }
+                }
+            }
+
+            barrier.wait();
+            if (w == 0) advance();
+        }
+    });
+
+    if (counters) {
+        for (const Counters& c : partial) {
+            counters->visited_nodes += c.visited_nodes;
+            counters->forward_arcs += c.forward_arcs;
+            counters->residual_arcs += c.residual_arcs;
+        }
+    }
+
+    return level[t] != -1;
+}
+
+template bool search(const Graph&, const FlowState&, int, int, int, std::vector<int>&,
+                     std::vector<std::pair<int, int>>*, Counters*, bool);
+template bool search(const Graph64&, const FlowState64&, int, int, int, std::vector<int>&,
+                     std::vector<std::pair<int, int>>*, Counters*, bool);
+
+} // namespace parallel_bfs
@@ -0,0 +1,224 @@
+#include "parallel_generator.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+
+namespace parallel_generator {
+
+namespace {
+    uint64_t mix(uint64_t z) {
+        z += 0x9e3779b97f4a7c15ULL;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    constexpr uint64_t block_size = 1 << 16; // Vertices per task
+
+    // Outline shared by the three families: s feeds vertices 1..width, vertices
+    // 1..inner have `degree` arcs each and the ones after them one arc to t
+    struct Layout {
+        uint64_t n;         // Vertices
+        uint64_t m;         // Arcs
+        uint64_t width;     // Vertices fed by s (rows, or the left side of a matching)
+        uint64_t inner;     // Vertices with `degree` arcs
+        uint64_t degree;
+    };
+
+    int64_t param(const Family& family, size_t i) {
+        return family.params[i];
+    }
+
+    Layout layout(const Family& family) {
+        static const size_t num_params[] = {0, 3, 3, 0, 3};
+        if (family.type != 1 && family.type != 2 && family.type != 4) {
+            throw std::runtime_error("Unsupported graph family: " + std::to_string(family.type) +
+                                     " (use 1 mesh, 2 random level or 4 matching)");
+        }
+        if (family.params.size() != num_params[family.type]) {
+            throw std::runtime_error("Graph family " + std::to_string(family.type) + " takes " +
+                                     std::to_string(num_params[family.type]) + " parameters");
+        }
+
+        int64_t range = param(family, 2);
+        if (range < 1 || range > std::numeric_limits<int32_t>::max() / 3) {
+            throw std::runtime_error("Capacity range out of bounds");
+        }
+
+        Layout l;
+        if (family.type == 4) {
+            int64_t n = param(family, 0), degree = param(family, 1);
+            if (n < 2 || degree < 1 || degree > n) throw std::runtime_error("Degenerate graph");
+            l.width = n;
+            l.inner = n;
+            l.degree = degree;
+            l.n = 2 * l.width + 2;
+        } else {
+            int64_t rows = param(family, 0), cols = param(family, 1);
+            if (rows < 3 || cols < 2) throw std::runtime_error("Degenerate graph");
+            l.width = rows;
+            l.inner = rows * (cols - 1);
+            l.degree = 3;
+            l.n = rows * cols + 2;
+        }
+        if (l.n > std::numeric_limits<uint32_t>::max()) {
+            throw std::runtime_error("Graph out of range");
+        }
+        l.m = l.width + l.inner * l.degree + l.width;
+        return l;
+    }
+
+    // Position of the first arc of u in the arc arrays (m for u >= n - 1)
+    uint64_t first_arc(const Layout& l, uint64_t u) {
+        if (u == 0) return 0;
+        if (u >= l.n - 1) return l.m;
+        uint64_t before = u - 1; // Vertices between s and u
+        return l.width + l.degree * std::min(before, l.inner) + (before > l.inner ? before - l.inner : 0);
+    }
+
+    // Appends the arcs of u, drawing from u's own random stream
+    void vertex_arcs(const Family& family, const Layout& l, uint64_t seed, uint64_t u,
+                     std::vector<uint32_t>& heads, std::vector<int32_t>& capacities) {
+        int32_t range = static_cast<int32_t>(param(family, 2));
+        int32_t terminal_capacity = family.type == 4 ? range : 3 * range;
+        uint64_t sink = l.n - 1;
+        auto arc = [&](uint64_t head, int32_t capacity) {
+            heads.push_back(static_cast<uint32_t>(head));
+            capacities.push_back(capacity);
+        };
+
+        if (u == sink) return;
+        if (u == 0) {
+            for (uint64_t i = 1; i <= l.width; ++i) arc(i, terminal_capacity);
+            return;
+        }
+        if (u > l.inner) {
+            arc(sink, terminal_capacity);
+            return;
+        }
+
+        VertexRandom rng(seed, u);
+        int64_t x[3];
+        if (family.type == 4) {
+            // Left vertex u: `degree` distinct right vertices n + x, all of capacity range
+            std::vector<int64_t> right(l.degree);
+            rng.subset(1, l.width, static_cast<int>(l.degree), right.data());
+            for (int64_t v : right) arc(l.width + v, range);
+        } else if (family.type == 1) {
+            // Mesh: the three neighbours of row j in the next column, wrapping around
+            uint64_t rows = l.width, next = ((u - 1) / rows + 1) * rows, j = (u - 1) % rows + 1;
+            arc(next + (j + rows - 2) % rows + 1, rng.integer(1, range));
+            arc(next + j, rng.integer(1, range));
+            arc(next + j % rows + 1, rng.integer(1, range));
+        } else {
+            // Random level: three distinct random vertices of the next column
+            uint64_t rows = l.width, next = ((u - 1) / rows + 1) * rows;
+            rng.subset(1, rows, 3, x);
+            for (int k = 0; k < 3; ++k) arc(next + x[k], rng.integer(1, range));
+        }
+    }
+
+    template <typename T>
+    void write_at(std::fstream& file, uint64_t position, const std::vector<T>& values) {
+        file.seekp(static_cast<std::streamoff>(position));
+        file.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+        if (!file) throw std::runtime_error("Error writing the graph file");
+    }
+} // namespace
+
+VertexRandom::VertexRandom(uint64_t seed, uint64_t vertex) : key(mix(mix(seed) + vertex)) {}
+
+uint64_t VertexRandom::next() {
+    return mix(key + 0x9e3779b97f4a7c15ULL * ++counter);
+}
+
+int32_t VertexRandom::integer(int32_t low, int32_t high) {
+    uint64_t span = static_cast<uint64_t>(high - low) + 1;
+    return low + static_cast<int32_t>(next() % span);
+}
+
+void VertexRandom::subset(int64_t low, int64_t high, int count, int64_t* x) {
+    if (high - low + 1 < count) {
+        throw std::runtime_error("Invalid range for random subset");
+    }
+    uint64_t span = static_cast<uint64_t>(high - low) + 1;
+    for (int i = 0; i < count;) {
+        int64_t r = low + static_cast<int64_t>(next() % span);
+        if (std::find(x, x + i, r) == x + i) x[i++] = r;
+    }
+}
+
+csr::Header describe(const Family& family) {
+    Layout l = layout(family);
+    csr::Header header;
+    std::copy(csr::magic, csr::magic + sizeof(csr::magic), header.magic);
+    header.n = l.n;
+    header.m = l.m;
+    header.source = 0;
+    header.sink = l.n - 1;
+    return header;
+}
+
+csr::Header write_csr(const Family& family, uint64_t seed, int workers, const std::string& path) {
+    Layout l = layout(family);
+    csr::Header header = describe(family);
+
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) throw std::runtime_error("Could not create " + path);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        uint64_t end = l.m;
+        out.seekp(static_cast<std::streamoff>(csr::offsets_position() + l.n * sizeof(uint64_t)));
+        out.write(reinterpret_cast<const char*>(&end), sizeof(end));
+        if (!out) throw std::runtime_error("Error writing the graph file");
+    }
+
+    if (workers <= 0) workers = thread_pool::default_workers();
+    uint64_t num_blocks = (l.n + block_size - 1) / block_size;
+    std::atomic<uint64_t> next_block{0};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    thread_pool::run(workers, [&](int) {
+        try {
+            // Each worker has its own handle; blocks never overlap in the file
+            std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+            if (!file) throw std::runtime_error("Could not open " + path);
+
+            std::vector<uint64_t> offsets;
+            std::vector<uint32_t> heads;
+            std::vector<int32_t> capacities;
+            for (uint64_t b = next_block++; b < num_blocks; b = next_block++) {
+                uint64_t first = b * block_size, last = std::min(l.n, first + block_size);
+                offsets.clear();
+                heads.clear();
+                capacities.clear();
+                for (uint64_t u = first; u < last; ++u) {
+                    offsets.push_back(first_arc(l, u));
+                    vertex_arcs(family, l, seed, u, heads, capacities);
+                }
+                if (heads.size() != first_arc(l, last) - first_arc(l, first)) {
+                    throw std::logic_error("Arc count of a block does not match the layout");
+                }
+
+                write_at(file, csr::offsets_position() + first * sizeof(uint64_t), offsets);
+                write_at(file, csr::heads_position(header) + first_arc(l, first) * sizeof(uint32_t), heads);
+                write_at(file, csr::capacities_position(header) + first_arc(l, first) * sizeof(int32_t), capacities);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) error = std::current_exception();
+            next_block = num_blocks; // Stop the other workers
+        }
+    });
+
+    if (error) std::rethrow_exception(error);
+    return header;
+}
+
+} // namespace parallel_generator
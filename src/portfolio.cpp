@@ -0,0 +1,37 @@
+#include "portfolio.hpp"
+#include "max_flow_solver.hpp"
+#include "thread_pool.hpp"
+#include <atomic>
+#include <stdexcept>
+
+template <typename Cap>
+BasicPortfolioResult<Cap> solve_portfolio(const BasicGraph<Cap>& graph, int s, int t, const std::vector<std::string>& strategies) {
+    std::atomic<bool> finished{false};
+    BasicPortfolioResult<Cap> result;
+
+    std::vector<BasicMaxFlowSolver<Cap>> solvers;
+    for (const std::string& name : strategies) {
+        BasicMaxFlowSolver<Cap> solver = make_solver<Cap>(name, &finished);
+        if (!solver) {
+            throw std::runtime_error("Unknown strategy in portfolio: " + name);
+        }
+        solvers.push_back(solver);
+    }
+
+    // One thread per strategy; the winner flips `finished`, which cancels the rest
+    thread_pool::run(static_cast<int>(solvers.size()), [&](int i) {
+        BasicFlowState<Cap> flow(graph);
+        Cap value = solvers[i](graph, flow, s, t);
+
+        if (!finished.exchange(true)) {
+            result.max_flow = value;
+            result.winner = strategies[i];
+            result.flow = std::move(flow);
+        }
+    });
+
+    return result;
+}
+
+template PortfolioResult solve_portfolio(const Graph&, int, int, const std::vector<std::string>&);
+template BasicPortfolioResult<long long> solve_portfolio(const Graph64&, int, int, const std::vector<std::string>&);
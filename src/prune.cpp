@@ -0,0 +1,107 @@
+#include "prune.hpp"
+#include <queue>
+
+// Marks the vertices reachable from `start` over arcs with capacity,
+// following them backwards if `reverse` is set
+template <typename Cap>
+static std::vector<char> reachable(const BasicGraph<Cap>& graph, int start, bool reverse) {
+    using Edge = BasicEdge<Cap>;
+    std::vector<char> seen(graph.size(), 0);
+    std::queue<int> q;
+    q.push(start);
+    seen[start] = 1;
+
+    while (!q.empty()) {
+        int u = q.front(); q.pop();
+        for (const Edge& e : graph.adj(u)) {
+            Cap cap = reverse ? graph.adj(e.to)[e.rev].capacity : e.capacity;
+            if (cap > 0 && !seen[e.to]) {
+                seen[e.to] = 1;
+                q.push(e.to);
+            }
+        }
+    }
+    return seen;
+}
+
+template <typename Cap>
+bool prune_graph(const BasicGraph<Cap>& graph, BasicPrunedGraph<Cap>& pruned) {
+    using Edge = BasicEdge<Cap>;
+    int n = graph.size();
+    int s = graph.get_source();
+    int t = graph.get_sink();
+
+    std::vector<char> from_s = reachable(graph, s, false);
+    std::vector<char> to_t = reachable(graph, t, true);
+
+    // New ids, in the input order
+    std::vector<int> index(n, -1);
+    std::vector<int> original;
+    for (int v = 0; v < n; ++v) {
+        if (v == s || v == t || (from_s[v] && to_t[v])) {
+            index[v] = static_cast<int>(original.size());
+            original.push_back(v);
+        }
+    }
+
+    auto keep_arc = [&](int u, const Edge& e) {
+        return e.capacity > 0 && index[u] != -1 && index[e.to] != -1 && e.to != s && u != t;
+    };
+
+    int kept_arcs = 0;
+    for (int u = 0; u < n; ++u) {
+        for (const Edge& e : graph.adj(u)) {
+            if (keep_arc(u, e)) ++kept_arcs;
+        }
+    }
+    if (static_cast<int>(original.size()) == n && kept_arcs == graph.num_edges()) {
+        return false;
+    }
+
+    BasicGraph<Cap> reduced(static_cast<int>(original.size()));
+    for (int u : original) {
+        for (const Edge& e : graph.adj(u)) {
+            if (keep_arc(u, e)) reduced.add_edge(index[u], index[e.to], e.capacity);
+        }
+    }
+    reduced.compress_graph();
+    reduced.set_terminals({index[s]}, {index[t]});
+
+    pruned.graph = std::move(reduced);
+    pruned.original = std::move(original);
+    return true;
+}
+
+template <typename Cap>
+void map_flow_back(const BasicGraph<Cap>& graph, const BasicPrunedGraph<Cap>& pruned, const BasicFlowState<Cap>& pruned_flow,
+                   BasicFlowState<Cap>& flow) {
+    using Edge = BasicEdge<Cap>;
+    const BasicGraph<Cap>& reduced = pruned.graph;
+    flow.fit(graph);
+    flow.reset();
+
+    // position[v] = index of the arc to v in adj(u), for the vertex u being copied
+    std::vector<int> position(graph.size(), -1);
+
+    for (int x = 0; x < reduced.size(); ++x) {
+        int u = pruned.original[x];
+        const auto& arcs = graph.adj(u);
+        for (size_t i = 0; i < arcs.size(); ++i) {
+            position[arcs[i].to] = static_cast<int>(i);
+        }
+
+        for (const Edge& e : reduced.adj(x)) {
+            if (!e.is_forward()) continue; // each pair once, from its forward half
+            Cap f = pruned_flow.flow(e);
+            if (f == 0) continue;
+
+            const Edge& a = arcs[position[pruned.original[e.to]]];
+            flow.augment(a, graph.adj(a.to)[a.rev], f);
+        }
+    }
+}
+
+template bool prune_graph(const Graph&, PrunedGraph&);
+template bool prune_graph(const Graph64&, BasicPrunedGraph<long long>&);
+template void map_flow_back(const Graph&, const PrunedGraph&, const FlowState&, FlowState&);
+template void map_flow_back(const Graph64&, const BasicPrunedGraph<long long>&, const FlowState64&, FlowState64&);
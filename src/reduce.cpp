@@ -0,0 +1,223 @@
+#include "reduce.hpp"
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+    // Live arcs around each vertex while contracting. Lists are never compacted,
+    // dead arcs are skipped; the counts only include live ones.
+    template <typename Cap>
+    struct Reducer {
+        using ReducedArc = BasicReducedArc<Cap>;
+
+        int n;
+        std::vector<ReducedArc>& arcs;
+        std::vector<Reduction>& steps;
+        std::vector<char> alive;
+        std::vector<std::vector<int>> in, out;
+        std::vector<int> in_count, out_count;
+        std::unordered_map<long long, int> by_ends; // live arc from -> to
+
+        Reducer(int n, std::vector<ReducedArc>& arcs, std::vector<Reduction>& steps)
+            : n(n), arcs(arcs), steps(steps), in(n), out(n), in_count(n, 0), out_count(n, 0) {}
+
+        long long key(int from, int to) const {
+            return static_cast<long long>(from) * n + to;
+        }
+
+        int add(int from, int to, Cap capacity) {
+            int id = static_cast<int>(arcs.size());
+            arcs.push_back({from, to, capacity});
+            alive.push_back(1);
+            out[from].push_back(id);
+            in[to].push_back(id);
+            ++out_count[from];
+            ++in_count[to];
+            return id;
+        }
+
+        void kill(int id) {
+            const ReducedArc& a = arcs[id];
+            alive[id] = 0;
+            --out_count[a.from];
+            --in_count[a.to];
+            auto it = by_ends.find(key(a.from, a.to));
+            if (it != by_ends.end() && it->second == id) by_ends.erase(it);
+        }
+
+        int first_live(const std::vector<int>& list) const {
+            for (int id : list) {
+                if (alive[id]) return id;
+            }
+            return -1;
+        }
+
+        // Replaces a = x -> v and b = v -> y by one arc x -> y, merged with any parallel one
+        void contract_series(int a, int b) {
+            int x = arcs[a].from;
+            int y = arcs[b].to;
+            Cap capacity = std::min(arcs[a].capacity, arcs[b].capacity);
+            kill(a);
+            kill(b);
+            if (x == y) return; // x -> v -> x only carries cycles
+
+            int c = add(x, y, capacity);
+            steps.push_back({true, c, {a, b}});
+
+            auto it = by_ends.find(key(x, y));
+            if (it == by_ends.end()) {
+                by_ends[key(x, y)] = c;
+                return;
+            }
+            int d = it->second;
+            int e = add(x, y, arcs[c].capacity + arcs[d].capacity);
+            kill(c);
+            kill(d);
+            steps.push_back({false, e, {d, c}});
+            by_ends[key(x, y)] = e;
+        }
+    };
+} // namespace
+
+template <typename Cap>
+bool reduce_graph(const BasicGraph<Cap>& graph, BasicReducedGraph<Cap>& reduced) {
+    using Edge = BasicEdge<Cap>;
+    int n = graph.size();
+    int s = graph.get_source();
+    int t = graph.get_sink();
+
+    std::vector<BasicReducedArc<Cap>> arcs;
+    std::vector<Reduction> steps;
+    std::vector<std::pair<int, int>> input_arc;
+    Reducer<Cap> reducer(n, arcs, steps);
+
+    // After compress_graph there is at most one arc per ordered pair
+    for (int u = 0; u < n; ++u) {
+        const auto& neighbors = graph.adj(u);
+        for (size_t i = 0; i < neighbors.size(); ++i) {
+            const Edge& e = neighbors[i];
+            if (e.capacity <= 0) continue;
+            int id = reducer.add(u, e.to, e.capacity);
+            reducer.by_ends[reducer.key(u, e.to)] = id;
+            input_arc.push_back({u, static_cast<int>(i)});
+        }
+    }
+
+    std::vector<char> removed(n, 0);
+    std::vector<int> pending;
+    for (int v = 0; v < n; ++v) {
+        if (v != s && v != t) pending.push_back(v);
+    }
+
+    // Each contraction may make its endpoints contractible, so they are queued again
+    bool changed = false;
+    while (!pending.empty()) {
+        int v = pending.back();
+        pending.pop_back();
+        if (removed[v] || v == s || v == t) continue;
+
+        if (reducer.in_count[v] == 0 || reducer.out_count[v] == 0) {
+            // No flow can pass through v
+            for (int id : reducer.in[v]) {
+                if (!reducer.alive[id]) continue;
+                reducer.kill(id);
+                pending.push_back(arcs[id].from);
+            }
+            for (int id : reducer.out[v]) {
+                if (!reducer.alive[id]) continue;
+                reducer.kill(id);
+                pending.push_back(arcs[id].to);
+            }
+        } else if (reducer.in_count[v] == 1 && reducer.out_count[v] == 1) {
+            int a = reducer.first_live(reducer.in[v]);
+            int b = reducer.first_live(reducer.out[v]);
+            pending.push_back(arcs[a].from);
+            pending.push_back(arcs[b].to);
+            reducer.contract_series(a, b);
+        } else {
+            continue;
+        }
+        removed[v] = 1;
+        changed = true;
+    }
+
+    if (!changed) return false;
+
+    // New ids, in the input order
+    std::vector<int> index(n, -1);
+    std::vector<int> original;
+    for (int v = 0; v < n; ++v) {
+        if (removed[v]) continue;
+        index[v] = static_cast<int>(original.size());
+        original.push_back(v);
+    }
+
+    BasicGraph<Cap> result(static_cast<int>(original.size()));
+    std::vector<int> live;
+    for (int id = 0; id < static_cast<int>(arcs.size()); ++id) {
+        if (!reducer.alive[id]) continue;
+        live.push_back(id);
+        result.add_edge(index[arcs[id].from], index[arcs[id].to], arcs[id].capacity);
+    }
+    result.compress_graph();
+    result.set_terminals({index[s]}, {index[t]});
+
+    reduced.graph = std::move(result);
+    reduced.original = std::move(original);
+    reduced.arcs = std::move(arcs);
+    reduced.input_arc = std::move(input_arc);
+    reduced.live = std::move(live);
+    reduced.steps = std::move(steps);
+    return true;
+}
+
+template <typename Cap>
+void map_flow_back(const BasicGraph<Cap>& graph, const BasicReducedGraph<Cap>& reduced, const BasicFlowState<Cap>& reduced_flow,
+                   BasicFlowState<Cap>& flow) {
+    using Edge = BasicEdge<Cap>;
+    const BasicGraph<Cap>& r = reduced.graph;
+    const auto& arcs = reduced.arcs;
+    std::vector<Cap> arc_flow(arcs.size(), 0);
+
+    // Flow of every live arc, read from the merged pairs of the reduced graph
+    std::vector<std::vector<int>> live_from(graph.size());
+    for (int id : reduced.live) live_from[arcs[id].from].push_back(id);
+
+    std::vector<int> position(graph.size(), -1);
+    for (int x = 0; x < r.size(); ++x) {
+        const auto& neighbors = r.adj(x);
+        for (size_t i = 0; i < neighbors.size(); ++i) {
+            position[reduced.original[neighbors[i].to]] = static_cast<int>(i);
+        }
+        for (int id : live_from[reduced.original[x]]) {
+            // Net flow of the pair; a positive flow in the other direction belongs to the other arc
+            arc_flow[id] = std::max<Cap>(0, reduced_flow.flow(neighbors[position[arcs[id].to]]));
+        }
+    }
+
+    // Undo the contractions, last first
+    for (auto it = reduced.steps.rbegin(); it != reduced.steps.rend(); ++it) {
+        Cap f = arc_flow[it->arc];
+        if (it->is_series) {
+            arc_flow[it->parts[0]] = f;
+            arc_flow[it->parts[1]] = f;
+        } else {
+            Cap first = std::min(f, arcs[it->parts[0]].capacity);
+            arc_flow[it->parts[0]] = first;
+            arc_flow[it->parts[1]] = f - first;
+        }
+    }
+
+    flow.fit(graph);
+    flow.reset();
+    for (size_t id = 0; id < reduced.input_arc.size(); ++id) {
+        if (arc_flow[id] == 0) continue;
+        const auto& [u, i] = reduced.input_arc[id];
+        const Edge& e = graph.adj(u)[i];
+        flow.augment(e, graph.adj(e.to)[e.rev], arc_flow[id]);
+    }
+}
+
+template bool reduce_graph(const Graph&, ReducedGraph&);
+template bool reduce_graph(const Graph64&, BasicReducedGraph<long long>&);
+template void map_flow_back(const Graph&, const ReducedGraph&, const FlowState&, FlowState&);
+template void map_flow_back(const Graph64&, const BasicReducedGraph<long long>&, const FlowState64&, FlowState64&);
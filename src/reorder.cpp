@@ -0,0 +1,125 @@
+#include "reorder.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+VertexOrder parse_vertex_order(const std::string& name) {
+    if (name == "bfs") return VertexOrder::BFS;
+    if (name == "rcm") return VertexOrder::RCM;
+    throw std::runtime_error("Unknown vertex order: " + name);
+}
+
+// Appends to `order` the vertices reached from `start`, ignoring arc directions.
+// With `by_degree` the neighbours of each vertex are taken by increasing degree (Cuthill-McKee).
+template <typename Cap>
+static void undirected_bfs(const BasicGraph<Cap>& graph, int start, bool by_degree, std::vector<char>& seen, std::vector<int>& order) {
+    size_t head = order.size();
+    order.push_back(start);
+    seen[start] = 1;
+
+    std::vector<int> next;
+    while (head < order.size()) {
+        int u = order[head++];
+        next.clear();
+        for (const auto& e : graph.adj(u)) {
+            if (!seen[e.to]) {
+                seen[e.to] = 1;
+                next.push_back(e.to);
+            }
+        }
+        if (by_degree) {
+            std::stable_sort(next.begin(), next.end(), [&](int a, int b) {
+                return graph.adj(a).size() < graph.adj(b).size();
+            });
+        }
+        order.insert(order.end(), next.begin(), next.end());
+    }
+}
+
+// Start of a Cuthill-McKee sweep: the George-Liu heuristic walks to a vertex of
+// minimum degree in the last BFS layer while the eccentricity keeps growing.
+// `level` must be all -1 and is left that way.
+template <typename Cap>
+static int pseudo_peripheral(const BasicGraph<Cap>& graph, int start, std::vector<int>& level) {
+    std::vector<int> queue;
+    int depth = -1;
+
+    for (int round = 0; round < 8; ++round) {
+        for (int u : queue) level[u] = -1;
+        queue.assign(1, start);
+        level[start] = 0;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            int u = queue[head];
+            for (const auto& e : graph.adj(u)) {
+                if (level[e.to] == -1) {
+                    level[e.to] = level[u] + 1;
+                    queue.push_back(e.to);
+                }
+            }
+        }
+
+        int last = level[queue.back()];
+        if (last <= depth) break;
+        depth = last;
+
+        int best = start;
+        for (auto it = queue.rbegin(); it != queue.rend() && level[*it] == last; ++it) {
+            if (best == start || graph.adj(*it).size() < graph.adj(best).size()) best = *it;
+        }
+        if (best == start) break;
+        start = best;
+    }
+    for (int u : queue) level[u] = -1;
+    return start;
+}
+
+template <typename Cap>
+BasicPrunedGraph<Cap> reorder_graph(const BasicGraph<Cap>& graph, VertexOrder order_type) {
+    int n = graph.size();
+    int s = graph.get_source();
+    int t = graph.get_sink();
+
+    std::vector<char> seen(n, 0);
+    std::vector<int> order;
+    order.reserve(n);
+
+    if (order_type == VertexOrder::BFS) {
+        undirected_bfs(graph, s, false, seen, order);
+        for (int v = 0; v < n; ++v) {
+            if (!seen[v]) undirected_bfs(graph, v, false, seen, order);
+        }
+    } else {
+        // One sweep per connected component, then the whole order is reversed
+        std::vector<int> level(n, -1);
+        for (int v = 0; v < n; ++v) {
+            if (seen[v]) continue;
+            std::vector<int> component;
+            undirected_bfs(graph, v, false, seen, component);
+            int start = *std::min_element(component.begin(), component.end(), [&](int a, int b) {
+                return graph.adj(a).size() < graph.adj(b).size();
+            });
+            start = pseudo_peripheral(graph, start, level);
+
+            for (int u : component) seen[u] = 0;
+            undirected_bfs(graph, start, true, seen, order);
+        }
+        std::reverse(order.begin(), order.end());
+    }
+
+    std::vector<int> index(n);
+    for (int x = 0; x < n; ++x) index[order[x]] = x;
+
+    BasicGraph<Cap> result(n);
+    for (int x = 0; x < n; ++x) {
+        for (const auto& e : graph.adj(order[x])) {
+            if (e.capacity > 0) result.add_edge(x, index[e.to], e.capacity);
+        }
+    }
+    result.compress_graph();
+    result.sort_arc_lists();
+    result.set_terminals({index[s]}, {index[t]});
+
+    return {std::move(result), std::move(order)};
+}
+
+template PrunedGraph reorder_graph(const Graph&, VertexOrder);
+template BasicPrunedGraph<long long> reorder_graph(const Graph64&, VertexOrder);
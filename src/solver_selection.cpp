@@ -0,0 +1,71 @@
+#include "solver_selection.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+template <typename Cap>
+InstanceFeatures compute_features(const BasicGraph<Cap>& graph, int s, int t) {
+    using Edge = BasicEdge<Cap>;
+    InstanceFeatures f;
+    f.n = graph.size();
+
+    for (int u = 0; u < f.n; ++u) {
+        for (const Edge& e : graph.adj(u)) {
+            if (e.capacity > 0) ++f.m;
+        }
+    }
+    if (f.n > 0) f.avg_out_degree = static_cast<double>(f.m) / f.n;
+
+    // Layered BFS from s over arcs with capacity, stopping at t's layer
+    std::vector<int> level(f.n, -1);
+    std::vector<int> layer = {s}, next;
+    level[s] = 0;
+    for (int depth = 0; !layer.empty(); ++depth) {
+        f.max_level_width = std::max(f.max_level_width, static_cast<int>(layer.size()));
+        if (level[t] != -1) break;
+        next.clear();
+        for (int u : layer) {
+            for (const Edge& e : graph.adj(u)) {
+                if (e.capacity > 0 && level[e.to] == -1) {
+                    level[e.to] = depth + 1;
+                    next.push_back(e.to);
+                }
+            }
+        }
+        layer.swap(next);
+    }
+    f.st_depth = level[t];
+
+    return f;
+}
+
+template InstanceFeatures compute_features(const Graph&, int, int);
+template InstanceFeatures compute_features(const Graph64&, int, int);
+
+std::string select_strategy(const InstanceFeatures& features, const std::vector<std::string>& candidates) {
+    std::vector<std::string> ranking;
+    if (features.st_depth <= 0) {
+        // Nothing to augment: a single search answers, the cheapest one is enough
+        ranking = {"bfs", "dinics", "scaling", "fat", "dfs"};
+    } else if (features.st_depth <= 3 && 16LL * features.st_depth * features.max_level_width < features.n &&
+               features.avg_out_degree <= 2.5) {
+        // Thin graph with t next to s: the layers in front of t hold a small part of the
+        // vertices, so the flow also takes the long paths beyond them, one Dinic phase per length
+        ranking = {"scaling", "fat", "dinics", "bfs", "dfs"};
+    } else if (features.st_depth <= 3 && features.max_level_width * 4 >= features.n) {
+        // Shallow and wide (matching-like): every path is short, random DFS finds them fastest
+        ranking = {"dinics", "dfs", "fat", "scaling", "bfs"};
+    } else {
+        // Deep layered graphs: many long augmenting paths, DFS degrades badly
+        ranking = {"dinics", "scaling", "fat", "bfs", "dfs"};
+    }
+
+    for (const std::string& name : ranking) {
+        if (std::find(candidates.begin(), candidates.end(), name) != candidates.end()) {
+            return name;
+        }
+    }
+    if (candidates.empty()) {
+        throw std::runtime_error("No candidate strategies");
+    }
+    return candidates.front();
+}
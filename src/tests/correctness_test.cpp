@@ -0,0 +1,1497 @@
+#include "graph.hpp"
+#include "flow_state.hpp"
+#include "ford_fulkerson.hpp"
+#include "dinics.hpp"
+#include "warm_start.hpp"
+#include "min_cut.hpp"
+#include "flow_decomposition.hpp"
+#include "gomory_hu.hpp"
+#include "max_flow_solver.hpp"
+#include "batch.hpp"
+#include "portfolio.hpp"
+#include "solver_selection.hpp"
+#include "parallel_bfs.hpp"
+#include "prune.hpp"
+#include "reduce.hpp"
+#include "reorder.hpp"
+#include "huge_pages.hpp"
+#include "numa.hpp"
+#include "parallel_generator.hpp"
+#include "csr.hpp"
+#include "find_path_headers/bfs.hpp"
+#include "find_path_headers/dfs_random.hpp"
+#include "generators.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Correctness checks of the solver features, run by `make check`. Random small
+// instances are solved by the code under test and compared with an independent
+// reference (a dense Edmonds-Karp over the arc list, which never touches Graph)
+// and with the invariants of a feasible flow. Prints one line per check and exits
+// with 1 if any of them failed.
+
+namespace {
+
+// An instance as plain data, so the reference never depends on Graph.
+// Arcs of the same ordered pair add up, as in read_dimacs.
+struct Instance {
+    int n = 0;
+    std::map<std::pair<int, int>, long long> capacity; // (u, v) -> capacity of u -> v
+    std::vector<int> sources = {0};
+    std::vector<int> sinks;
+};
+
+int failures = 0;
+
+void expect(bool ok, const std::string& what) {
+    if (!ok) {
+        ++failures;
+        std::cerr << "  FAIL: " << what << "\n";
+    }
+}
+
+// Edmonds-Karp on a capacity matrix. Terminal sets are joined by a super source
+// and a super sink of unbounded capacity.
+long long reference_max_flow(const Instance& instance) {
+    int n = instance.n + 2, s = instance.n, t = instance.n + 1;
+    long long unbounded = 1;
+    for (const auto& [arc, c] : instance.capacity) unbounded += c;
+
+    std::vector<std::vector<long long>> residual(n, std::vector<long long>(n, 0));
+    for (const auto& [arc, c] : instance.capacity) residual[arc.first][arc.second] += c;
+    for (int v : instance.sources) residual[s][v] = unbounded;
+    for (int v : instance.sinks) residual[v][t] = unbounded;
+
+    long long total = 0;
+    std::vector<int> parent(n);
+    while (true) {
+        std::fill(parent.begin(), parent.end(), -1);
+        parent[s] = s;
+        std::vector<int> queue = {s};
+        for (size_t i = 0; i < queue.size() && parent[t] == -1; ++i) {
+            int u = queue[i];
+            for (int v = 0; v < n; ++v) {
+                if (parent[v] == -1 && residual[u][v] > 0) {
+                    parent[v] = u;
+                    queue.push_back(v);
+                }
+            }
+        }
+        if (parent[t] == -1) return total;
+
+        long long pushed = unbounded;
+        for (int v = t; v != s; v = parent[v]) pushed = std::min(pushed, residual[parent[v]][v]);
+        for (int v = t; v != s; v = parent[v]) {
+            residual[parent[v]][v] -= pushed;
+            residual[v][parent[v]] += pushed;
+        }
+        total += pushed;
+    }
+}
+
+template <typename Cap = int>
+BasicGraph<Cap> build(const Instance& instance) {
+    BasicGraph<Cap> graph(instance.n);
+    for (const auto& [arc, c] : instance.capacity) graph.add_edge(arc.first, arc.second, static_cast<Cap>(c));
+    graph.compress_graph();
+    graph.set_terminals(instance.sources, instance.sinks);
+    return graph;
+}
+
+// Random instance with n in [2, max_n]: up to 3n arcs of capacity 1..max_capacity,
+// with self-loops skipped and antiparallel arcs as likely as any other
+Instance random_instance(generators::Random& rng, int max_n, int max_capacity) {
+    Instance instance;
+    instance.n = rng.integer(2, max_n);
+    instance.sinks = {instance.n - 1};
+    int m = rng.integer(0, 3 * instance.n);
+    for (int i = 0; i < m; ++i) {
+        int u = rng.integer(0, instance.n - 1), v = rng.integer(0, instance.n - 1);
+        if (u != v) instance.capacity[{u, v}] += rng.integer(1, max_capacity);
+    }
+    return instance;
+}
+
+// Empty if `flow` is a feasible s-t flow of value `value` on `graph`: every arc
+// carries the opposite of its reverse and at most its capacity (so 0 <= f <= c on
+// each input arc of a merged pair), and flow is conserved outside s and t
+template <typename Cap>
+std::string flow_error(const BasicGraph<Cap>& graph, const BasicFlowState<Cap>& flow, int s, int t, Cap value) {
+    std::vector<Cap> net(graph.size(), 0);
+    for (int u = 0; u < graph.size(); ++u) {
+        for (const auto& e : graph.adj(u)) {
+            const auto& r = graph.adj(e.to)[e.rev];
+            if (r.to != u || flow.flow(e) != -flow.flow(r)) return "arc pair out of sync at " + e.to_string(u);
+            if (flow.flow(e) > e.capacity) return "capacity exceeded on " + e.to_string(u);
+            net[u] += flow.flow(e);
+        }
+    }
+    for (int v = 0; v < graph.size(); ++v) {
+        if (v != s && v != t && net[v] != 0) return "flow not conserved at " + std::to_string(v);
+    }
+    if (net[s] != value || net[t] != -value) return "flow value differs from " + std::to_string(value);
+    return "";
+}
+
+// Sets u -> v to `c` in both the instance and the graph (the pair must exist in the graph)
+void set_capacity(Instance& instance, Graph& graph, int u, int v, int c) {
+    instance.capacity[{u, v}] = c;
+    graph.set_capacity(u, v, c);
+}
+
+// Cuts and raises random capacities between warm re-solves (Dinic and BFS
+// Ford-Fulkerson in turn) and compares each result with the reference, with a
+// cold solve of the edited graph and with the flow invariants
+void check_warm_start() {
+    generators::Random rng(26);
+    for (int trial = 0; trial < 300; ++trial) {
+        Instance instance = random_instance(rng, 12, 20);
+        Graph graph = build(instance);
+        int s = graph.get_source(), t = graph.get_sink();
+        FlowState flow(graph);
+        dinic_max_flow(graph, flow, s, t);
+
+        for (int round = 0; round < 4 && !instance.capacity.empty(); ++round) {
+            int edits = rng.integer(1, 4);
+            for (int i = 0; i < edits; ++i) {
+                auto it = std::next(instance.capacity.begin(), rng.integer(0, static_cast<int>(instance.capacity.size()) - 1));
+                auto [u, v] = it->first;
+                if (rng.integer(0, 3) == 0) std::swap(u, v); // the reverse half of the pair exists too
+                int c = static_cast<int>(instance.capacity[{u, v}]);
+                set_capacity(instance, graph, u, v, rng.integer(0, 1) ? rng.integer(0, c) : c + rng.integer(1, 10));
+            }
+
+            int value;
+            if (round % 2 == 0) {
+                value = warm_dinic_max_flow(graph, flow, s, t);
+            } else {
+                FFStats stats;
+                value = warm_ford_fulkerson(graph, flow, s, t, BasicPathFindingStrategy<int>(bfs_path<int>),
+                                            AlgorithmType::BFS_EDMONDS_KARP, &stats);
+            }
+
+            Graph cold = build(instance);
+            FlowState cold_flow(cold);
+            std::string where = " (trial " + std::to_string(trial) + ", round " + std::to_string(round) + ")";
+            expect(value == reference_max_flow(instance), "warm value differs from the reference" + where);
+            expect(value == dinic_max_flow(cold, cold_flow, cold.get_source(), cold.get_sink()),
+                   "warm value differs from a cold solve" + where);
+            std::string error = flow_error(graph, flow, s, t, value);
+            expect(error.empty(), error + where);
+        }
+    }
+}
+
+// Empty if every arc has a matching reverse half, the two halves of a pair hold
+// consecutive flow slots of their own, each ordered pair appears once and the
+// capacities are those of the instance
+std::string structure_error(const Graph& graph, const Instance& instance) {
+    std::vector<char> used(graph.num_arc_slots(), 0);
+    for (int u = 0; u < graph.size(); ++u) {
+        std::vector<char> seen(graph.size(), 0);
+        for (size_t i = 0; i < graph.adj(u).size(); ++i) {
+            const Edge& e = graph.adj(u)[i];
+            if (e.to < 0 || e.to >= graph.size() || e.to == u) return "bad head on " + e.to_string(u);
+            if (seen[e.to]++) return "pair listed twice at " + e.to_string(u);
+            const Edge& r = graph.adj(e.to)[e.rev];
+            if (r.to != u || r.rev != static_cast<int>(i)) return "reverse index broken at " + e.to_string(u);
+            if (e.arc < 0 || e.arc >= graph.num_arc_slots() || used[e.arc]++ || (e.arc ^ 1) != r.arc) {
+                return "flow slot broken at " + e.to_string(u);
+            }
+            auto it = instance.capacity.find({u, e.to});
+            if (e.capacity != (it == instance.capacity.end() ? 0 : it->second)) return "capacity differs at " + e.to_string(u);
+        }
+    }
+    for (const auto& [arc, c] : instance.capacity) {
+        if (c > 0 && graph.find_arc(arc.first, arc.second) == -1) return "arc missing";
+    }
+    return "";
+}
+
+// Interleaves add_arc (new pairs, merges into either half, enough to move lists to
+// the end of the block more than once), remove_arc and capacity edits with warm
+// re-solves. Each result is compared with the reference and with a graph rebuilt
+// from scratch; the arc block must stay consistent and removed pairs without
+// capacity left must be erased.
+void check_dynamic_arcs() {
+    generators::Random rng(27);
+    for (int trial = 0; trial < 200; ++trial) {
+        Instance instance = random_instance(rng, 30, 20);
+        Graph graph = build(instance);
+        int s = graph.get_source(), t = graph.get_sink();
+        FlowState flow(graph);
+        dinic_max_flow(graph, flow, s, t);
+
+        for (int round = 0; round < 6; ++round) {
+            std::vector<std::pair<int, int>> removed;
+            int edits = rng.integer(1, 3 * instance.n);
+            for (int i = 0; i < edits; ++i) {
+                int u = rng.integer(0, instance.n - 1), v = rng.integer(0, instance.n - 1);
+                if (u == v) continue;
+                int kind = rng.integer(0, 3);
+                if (kind <= 1 || graph.find_arc(u, v) == -1) {
+                    int c = rng.integer(0, 20);
+                    instance.capacity[{u, v}] += c;
+                    graph.add_arc(u, v, c);
+                } else if (kind == 2) {
+                    instance.capacity[{u, v}] = 0;
+                    graph.remove_arc(u, v);
+                    removed.push_back({u, v});
+                } else {
+                    set_capacity(instance, graph, u, v, rng.integer(0, 20));
+                }
+            }
+
+            // A broken arc block could send the solver around in circles, so stop the trial first
+            std::string where = " (trial " + std::to_string(trial) + ", round " + std::to_string(round) + ")";
+            std::string error = structure_error(graph, instance);
+            expect(error.empty(), error + " before solving" + where);
+            if (!error.empty()) break;
+
+            int value = warm_dinic_max_flow(graph, flow, s, t);
+            Graph rebuilt = build(instance);
+            FlowState rebuilt_flow(rebuilt);
+            expect(value == reference_max_flow(instance), "warm value differs from the reference" + where);
+            expect(value == dinic_max_flow(rebuilt, rebuilt_flow, rebuilt.get_source(), rebuilt.get_sink()),
+                   "warm value differs from the rebuilt graph" + where);
+            error = flow_error(graph, flow, s, t, value);
+            expect(error.empty(), error + where);
+            error = structure_error(graph, instance);
+            expect(error.empty(), error + where);
+            for (auto [u, v] : removed) {
+                bool unused = instance.capacity[{u, v}] == 0 && instance.capacity[{v, u}] == 0;
+                expect(!unused || graph.find_arc(u, v) == -1, "removed pair not erased" + where);
+            }
+        }
+    }
+}
+
+// Empty if `cut` separates the terminals of `instance` with capacity `value`,
+// counting the capacity on the input arc list rather than on the graph
+template <typename Cap>
+std::string cut_error(const BasicGraph<Cap>& graph, const BasicMinCut<Cap>& cut, const Instance& instance, long long value) {
+    const std::vector<char>& side = cut.source_side;
+    for (int v : instance.sources) {
+        if (!side[v]) return "source " + std::to_string(v) + " outside the s side";
+    }
+    for (int v : instance.sinks) {
+        if (side[v]) return "sink " + std::to_string(v) + " on the s side";
+    }
+
+    long long crossing = 0;
+    for (const auto& [arc, c] : instance.capacity) {
+        if (side[arc.first] && !side[arc.second]) crossing += c;
+    }
+    if (crossing != value) return "arcs leaving the s side hold " + std::to_string(crossing) + ", not " + std::to_string(value);
+
+    long long listed = 0;
+    for (const auto& [u, idx] : cut.arcs) {
+        const auto& e = graph.adj(u)[idx];
+        if (!side[u] || side[e.to]) return "listed arc does not cross the cut: " + e.to_string(u);
+        listed += e.capacity;
+    }
+    if (listed != value || cut.capacity != value) return "cut capacity differs from " + std::to_string(value);
+    return "";
+}
+
+// The cut of the final residual graph (BFS Ford-Fulkerson) and the one Dinic
+// returns must both have the capacity of the max flow, and write_cut must
+// report it with one line per source-side vertex and per cut arc
+void check_min_cut() {
+    generators::Random rng(28);
+    for (int trial = 0; trial < 300; ++trial) {
+        Instance instance = random_instance(rng, 15, 20);
+        Graph graph = build(instance);
+        int s = graph.get_source(), t = graph.get_sink();
+        long long expected = reference_max_flow(instance);
+        std::string where = " (trial " + std::to_string(trial) + ")";
+
+        FlowState flow(graph);
+        FFStats stats;
+        ford_fulkerson(graph, flow, s, t, BasicPathFindingStrategy<int>(bfs_path<int>), AlgorithmType::BFS_EDMONDS_KARP, &stats);
+        MinCut residual_cut = min_cut(graph, flow, s);
+        std::string error = cut_error(graph, residual_cut, instance, expected);
+        expect(error.empty(), "residual cut: " + error + where);
+
+        flow.reset();
+        std::vector<char> source_side;
+        dinic_max_flow(graph, flow, s, t, &source_side);
+        MinCut dinic_cut = min_cut_from_side(graph, source_side);
+        error = cut_error(graph, dinic_cut, instance, expected);
+        expect(error.empty(), "Dinic cut: " + error + where);
+
+        std::ostringstream out;
+        write_cut(graph, dinic_cut, out);
+        std::istringstream in(out.str());
+        std::string p, kind, line;
+        long long capacity = -1, side_size = -1, num_arcs = -1, listed = 0, vertices = 0;
+        in >> p >> kind >> capacity >> side_size >> num_arcs;
+        std::getline(in, line);
+        int lines = 0;
+        while (std::getline(in, line)) {
+            std::istringstream fields(line);
+            char tag;
+            int u, v;
+            long long c;
+            fields >> tag >> u;
+            if (tag == 'n') {
+                ++vertices;
+            } else if (fields >> v >> c) {
+                listed += c;
+            }
+            ++lines;
+        }
+        expect(p == "p" && kind == "cut" && capacity == expected && vertices == side_size && lines == side_size + num_arcs &&
+               listed == expected, "write_cut output does not describe the cut" + where);
+    }
+}
+
+// Pushes flow around one residual cycle found by a random walk, if the walk meets
+// itself: the flow stays feasible with the same value but is no longer acyclic
+void add_residual_cycle(const Graph& graph, FlowState& flow, generators::Random& rng) {
+    std::vector<int> pos(graph.size(), -1);
+    std::vector<std::pair<int, int>> walk; // (vertex, index of the arc taken in its list)
+    int u = rng.integer(0, graph.size() - 1);
+    while (pos[u] == -1) {
+        std::vector<int> open;
+        for (size_t i = 0; i < graph.adj(u).size(); ++i) {
+            if (flow.remaining_capacity(graph.adj(u)[i]) > 0) open.push_back(static_cast<int>(i));
+        }
+        if (open.empty()) return;
+        pos[u] = static_cast<int>(walk.size());
+        walk.push_back({u, open[rng.integer(0, static_cast<int>(open.size()) - 1)]});
+        u = graph.adj(u)[walk.back().second].to;
+    }
+
+    int amount = std::numeric_limits<int>::max();
+    for (size_t i = pos[u]; i < walk.size(); ++i) {
+        amount = std::min(amount, flow.remaining_capacity(graph.adj(walk[i].first)[walk[i].second]));
+    }
+    for (size_t i = pos[u]; i < walk.size(); ++i) {
+        const Edge& e = graph.adj(walk[i].first)[walk[i].second];
+        flow.augment(e, graph.adj(e.to)[e.rev], amount);
+    }
+}
+
+// Decomposes the flows of Dinic and random DFS, with residual cycles pushed on top,
+// and checks that the paths run s ... t and carry the flow value, that cycles close,
+// and that adding up all components gives back the flow of every arc
+void check_flow_decomposition() {
+    generators::Random rng(29);
+    dfs_random_seed(29);
+    int cycles = 0;
+    for (int trial = 0; trial < 300; ++trial) {
+        Instance instance = random_instance(rng, 15, 20);
+        Graph graph = build(instance);
+        int s = graph.get_source(), t = graph.get_sink();
+        FlowState flow(graph);
+        int value;
+        if (trial % 2 == 0) {
+            value = dinic_max_flow(graph, flow, s, t);
+        } else {
+            FFStats stats;
+            value = ford_fulkerson(graph, flow, s, t, BasicPathFindingStrategy<int>(dfs_path<int>), AlgorithmType::DFS_RANDOM, &stats);
+        }
+        for (int i = 0; i < 3; ++i) add_residual_cycle(graph, flow, rng);
+
+        std::string where = " (trial " + std::to_string(trial) + ")";
+        std::map<std::pair<int, int>, long long> carried; // flow of the components over u -> v
+        long long path_flow = 0;
+        bool well_formed = true;
+        int components = decompose_flow<int>(graph, flow, s, t, [&](bool is_cycle, int amount, const int* vertices, int count) {
+            if (is_cycle) {
+                ++cycles;
+                well_formed &= count >= 3 && vertices[0] == vertices[count - 1];
+            } else {
+                path_flow += amount;
+                well_formed &= count >= 2 && vertices[0] == s && vertices[count - 1] == t;
+            }
+            well_formed &= amount > 0;
+            for (int i = 0; i + 1 < count; ++i) carried[{vertices[i], vertices[i + 1]}] += amount;
+        });
+        expect(well_formed, "malformed path or cycle" + where);
+        expect(path_flow == value, "paths carry " + std::to_string(path_flow) + " instead of " + std::to_string(value) + where);
+
+        int positive = 0;
+        bool matches = true;
+        for (int u = 0; u < graph.size(); ++u) {
+            for (const Edge& e : graph.adj(u)) {
+                positive += flow.flow(e) > 0;
+                auto it = carried.find({u, e.to});
+                matches &= std::max(0, flow.flow(e)) == (it == carried.end() ? 0 : it->second);
+            }
+        }
+        expect(matches, "components do not add up to the flow of every arc" + where);
+        expect(components <= positive, "more components than arcs with flow" + where);
+
+        std::ostringstream out;
+        int written = write_flow_decomposition(graph, flow, s, t, out);
+        std::istringstream in(out.str());
+        std::string line;
+        long long written_path_flow = 0;
+        int lines = 0;
+        while (std::getline(in, line)) {
+            std::istringstream fields(line);
+            std::string kind;
+            long long amount;
+            fields >> kind >> amount;
+            if (kind == "path") written_path_flow += amount;
+            ++lines;
+        }
+        expect(written == components && lines == components && written_path_flow == value,
+               "write_flow_decomposition output does not match the decomposition" + where);
+    }
+    expect(cycles > 0, "no cycle was ever decomposed");
+}
+
+// DIMACS text of an instance, with one `n` line per terminal
+std::string to_dimacs(const Instance& instance) {
+    std::ostringstream out;
+    out << "p max " << instance.n << " " << instance.capacity.size() << "\n";
+    for (int v : instance.sources) out << "n " << v + 1 << " s\n";
+    for (int v : instance.sinks) out << "n " << v + 1 << " t\n";
+    for (const auto& [arc, c] : instance.capacity) out << "a " << arc.first + 1 << " " << arc.second + 1 << " " << c << "\n";
+    return out.str();
+}
+
+// Random instance with disjoint sets of one to three sources and sinks
+Instance random_multi_terminal_instance(generators::Random& rng) {
+    Instance instance = random_instance(rng, 15, 20);
+    instance.n = std::max(instance.n, 2);
+    std::vector<int> vertices(instance.n);
+    for (int v = 0; v < instance.n; ++v) vertices[v] = v;
+    for (int i = instance.n - 1; i > 0; --i) std::swap(vertices[i], vertices[rng.integer(0, i)]);
+    int num_sources = rng.integer(1, std::min(3, instance.n - 1));
+    int num_sinks = rng.integer(1, std::min(3, instance.n - num_sources));
+    instance.sources.assign(vertices.begin(), vertices.begin() + num_sources);
+    instance.sinks.assign(vertices.begin() + num_sources, vertices.begin() + num_sources + num_sinks);
+    return instance;
+}
+
+// Terminal sets, read from DIMACS `n` lines and solved through super terminals:
+// the value must match the reference (which joins the sets with unbounded arcs), the
+// cut must keep every input source and sink on its side and the paths must run from
+// an input source to an input sink. Then arcs out of sources and into sinks are raised
+// and added, which the super arcs must follow, and the warm re-solve is compared again.
+void check_multi_terminal() {
+    generators::Random rng(30);
+    for (int trial = 0; trial < 300; ++trial) {
+        Instance instance = random_multi_terminal_instance(rng);
+        std::istringstream text(to_dimacs(instance));
+        InputGraph input = read_graph(text);
+        Graph& graph = input.graph;
+        int s = graph.get_source(), t = graph.get_sink();
+        std::string where = " (trial " + std::to_string(trial) + ")";
+
+        FlowState flow(graph);
+        std::vector<char> source_side;
+        int value = dinic_max_flow(graph, flow, s, t, &source_side);
+        expect(!input.is_wide && value == reference_max_flow(instance), "value differs from the reference" + where);
+        std::string error = flow_error(graph, flow, s, t, value);
+        expect(error.empty(), error + where);
+        error = cut_error(graph, min_cut_from_side(graph, source_side), instance, value);
+        expect(error.empty(), "cut: " + error + where);
+
+        std::ostringstream out;
+        write_flow_decomposition(graph, flow, s, t, out);
+        std::istringstream paths(out.str());
+        std::string line;
+        bool endpoints = true;
+        while (std::getline(paths, line)) {
+            std::istringstream fields(line);
+            std::string kind;
+            int amount;
+            std::vector<int> vertices;
+            fields >> kind >> amount;
+            for (int v; fields >> v;) vertices.push_back(v - 1);
+            if (kind != "path") continue;
+            endpoints &= !vertices.empty() &&
+                         std::count(instance.sources.begin(), instance.sources.end(), vertices.front()) == 1 &&
+                         std::count(instance.sinks.begin(), instance.sinks.end(), vertices.back()) == 1;
+        }
+        expect(endpoints, "a path does not run from an input source to an input sink" + where);
+
+        for (int round = 0; round < 3; ++round) {
+            int edits = rng.integer(1, 4);
+            for (int i = 0; i < edits; ++i) {
+                bool from_source = rng.integer(0, 1);
+                const std::vector<int>& terminals = from_source ? instance.sources : instance.sinks;
+                int v = terminals[rng.integer(0, static_cast<int>(terminals.size()) - 1)];
+                int w = rng.integer(0, instance.n - 1);
+                if (v == w) continue;
+                int u = from_source ? v : w, x = from_source ? w : v;
+                int c = rng.integer(1, 30);
+                if (graph.find_arc(u, x) != -1 && rng.integer(0, 1)) {
+                    set_capacity(instance, graph, u, x, static_cast<int>(instance.capacity[{u, x}]) + c);
+                } else {
+                    instance.capacity[{u, x}] += c;
+                    graph.add_arc(u, x, c);
+                }
+            }
+
+            value = warm_dinic_max_flow(graph, flow, s, t);
+            std::string round_where = " (trial " + std::to_string(trial) + ", round " + std::to_string(round) + ")";
+            expect(value == reference_max_flow(instance), "warm value after raising terminal arcs differs from the reference" + round_where);
+            error = flow_error(graph, flow, s, t, value);
+            expect(error.empty(), error + round_where);
+        }
+    }
+}
+
+// The same vertices with each arc u -> v of capacity c turned into an edge {u, v}
+// of capacity c, from s to t
+Instance undirected_instance(const Instance& instance, int s, int t) {
+    Instance undirected;
+    undirected.n = instance.n;
+    for (const auto& [arc, c] : instance.capacity) {
+        undirected.capacity[arc] += c;
+        undirected.capacity[{arc.second, arc.first}] += c;
+    }
+    undirected.sources = {s};
+    undirected.sinks = {t};
+    return undirected;
+}
+
+// Gomory-Hu trees built with one and three workers, by Dinic and by BFS
+// Ford-Fulkerson: the smallest weight on the tree path between every pair of
+// vertices must be the reference max flow between them on the undirected graph
+void check_gomory_hu() {
+    generators::Random rng(31);
+    for (int trial = 0; trial < 100; ++trial) {
+        Instance instance = random_instance(rng, 10, 20);
+        Graph graph = build(instance);
+        int workers = trial % 2 == 0 ? 1 : 3;
+        GomoryHuTree tree = gomory_hu_tree(graph, make_solver(trial % 4 < 2 ? "dinics" : "bfs"), workers);
+        std::string where = " (trial " + std::to_string(trial) + ", " + std::to_string(workers) + " workers)";
+
+        bool is_tree = tree.parent.size() == static_cast<size_t>(instance.n) && tree.parent[0] == -1;
+        for (int v = 1; is_tree && v < instance.n; ++v) {
+            int steps = 0;
+            for (int x = v; x != -1 && steps <= instance.n; x = tree.parent[x]) ++steps;
+            is_tree &= steps <= instance.n;
+        }
+        expect(is_tree, "parents do not form a tree rooted at 0" + where);
+        if (!is_tree) continue;
+
+        for (int u = 0; u < instance.n; ++u) {
+            for (int v = u + 1; v < instance.n; ++v) {
+                long long expected = reference_max_flow(undirected_instance(instance, u, v));
+                expect(tree.min_cut(u, v) == expected,
+                       "min cut " + std::to_string(u) + "-" + std::to_string(v) + " differs from the reference" + where);
+            }
+        }
+    }
+}
+
+// Reads random query files (with a comment line) and solves them with one and
+// three workers: the output must list every query once, in input order, with the
+// reference max flow between its two vertices
+void check_batch() {
+    generators::Random rng(32);
+    const std::vector<std::string> names = {"bfs", "dfs", "fat", "scaling", "dinics"};
+    for (int trial = 0; trial < 100; ++trial) {
+        Instance instance = random_instance(rng, 12, 20);
+        Graph graph = build(instance);
+
+        std::ostringstream file;
+        file << "c random pairs\n";
+        std::vector<std::pair<int, int>> pairs;
+        int q = rng.integer(1, 20);
+        for (int i = 0; i < q; ++i) {
+            int s = rng.integer(0, instance.n - 1), t = rng.integer(0, instance.n - 1);
+            if (s == t) continue;
+            pairs.push_back({s, t});
+            file << s + 1 << " " << t + 1 << "\n";
+        }
+        std::istringstream in(file.str());
+        std::vector<STQuery> queries = read_queries(in, instance.n);
+
+        int workers = trial % 2 == 0 ? 1 : 3;
+        std::string name = names[trial % names.size()];
+        std::ostringstream out;
+        solve_batch(graph, queries, make_solver(name), workers, out);
+        std::string where = " (trial " + std::to_string(trial) + ", " + name + ", " + std::to_string(workers) + " workers)";
+
+        std::istringstream results(out.str());
+        size_t i = 0;
+        bool matches = queries.size() == pairs.size();
+        for (int s, t; results >> s >> t; ++i) {
+            long long flow;
+            results >> flow;
+            if (i >= pairs.size() || s != pairs[i].first + 1 || t != pairs[i].second + 1) {
+                matches = false;
+                break;
+            }
+            Instance query = instance;
+            query.sources = {pairs[i].first};
+            query.sinks = {pairs[i].second};
+            expect(flow == reference_max_flow(query), "query " + std::to_string(i) + " differs from the reference" + where);
+        }
+        expect(matches && i == pairs.size(), "queries missing or out of order in the output" + where);
+    }
+}
+
+// Every arc of the graph as (tail, head, reverse index, flow slot, capacity)
+std::vector<std::array<long long, 5>> snapshot(const Graph& graph) {
+    std::vector<std::array<long long, 5>> arcs;
+    for (int u = 0; u < graph.size(); ++u) {
+        for (const Edge& e : graph.adj(u)) arcs.push_back({u, e.to, e.rev, e.arc, e.capacity});
+    }
+    return arcs;
+}
+
+// Four threads solve different s-t pairs of one const Graph at the same time, each
+// with its own FlowState and strategy: every value must match the reference, every
+// flow must be feasible, and the shared graph must come out unchanged
+void check_shared_graph() {
+    generators::Random rng(33);
+    const std::vector<std::string> names = {"bfs", "fat", "scaling", "dinics"};
+    for (int trial = 0; trial < 50; ++trial) {
+        Instance instance = random_instance(rng, 15, 20);
+        const Graph graph = build(instance);
+        auto before = snapshot(graph);
+
+        constexpr int num_threads = 4, per_thread = 10;
+        std::vector<std::pair<int, int>> pairs;
+        std::vector<long long> expected;
+        for (int i = 0; i < num_threads * per_thread; ++i) {
+            int s = rng.integer(0, instance.n - 1), t = (s + rng.integer(1, instance.n - 1)) % instance.n;
+            Instance query = instance;
+            query.sources = {s};
+            query.sinks = {t};
+            pairs.push_back({s, t});
+            expected.push_back(reference_max_flow(query));
+        }
+
+        std::vector<long long> values(pairs.size());
+        std::vector<std::string> errors(pairs.size());
+        std::vector<std::thread> threads;
+        for (int w = 0; w < num_threads; ++w) {
+            threads.emplace_back([&, w] {
+                MaxFlowSolver solve = make_solver(names[w]);
+                FlowState flow(graph);
+                for (int i = w * per_thread; i < (w + 1) * per_thread; ++i) {
+                    flow.reset();
+                    int value = solve(graph, flow, pairs[i].first, pairs[i].second);
+                    values[i] = value;
+                    errors[i] = flow_error(graph, flow, pairs[i].first, pairs[i].second, value);
+                }
+            });
+        }
+        for (std::thread& thread : threads) thread.join();
+
+        std::string where = " (trial " + std::to_string(trial) + ")";
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            expect(values[i] == expected[i], names[i / per_thread] + " differs from the reference" + where);
+            expect(errors[i].empty(), errors[i] + where);
+        }
+        expect(snapshot(graph) == before, "the shared graph changed" + where);
+    }
+}
+
+// Races the default portfolio and random subsets of it: the answer must be the
+// reference value, the winner one of the raced strategies and its flow feasible
+void check_portfolio() {
+    generators::Random rng(34);
+    for (int trial = 0; trial < 100; ++trial) {
+        Instance instance = random_instance(rng, 15, 20);
+        Graph graph = build(instance);
+        int s = graph.get_source(), t = graph.get_sink();
+
+        std::vector<std::string> strategies;
+        for (const std::string& name : default_portfolio) {
+            if (trial % 2 == 0 || rng.integer(0, 1)) strategies.push_back(name);
+        }
+        if (strategies.empty()) strategies.push_back("dinics");
+
+        PortfolioResult result = solve_portfolio(graph, s, t, strategies);
+        std::string where = " (trial " + std::to_string(trial) + ", won by " + result.winner + ")";
+        expect(result.max_flow == reference_max_flow(instance), "value differs from the reference" + where);
+        expect(std::count(strategies.begin(), strategies.end(), result.winner) == 1, "winner was not raced" + where);
+        std::string error = flow_error(graph, result.flow, s, t, result.max_flow);
+        expect(error.empty(), error + where);
+    }
+}
+
+// The arcs with capacity of a graph as an instance, with its terminals
+Instance instance_of(const Graph& graph) {
+    Instance instance;
+    instance.n = graph.size();
+    for (int u = 0; u < graph.size(); ++u) {
+        for (const Edge& e : graph.adj(u)) {
+            if (e.capacity > 0) instance.capacity[{u, e.to}] = e.capacity;
+        }
+    }
+    instance.sources = {graph.get_source()};
+    instance.sinks = {graph.get_sink()};
+    return instance;
+}
+
+// Arcs on a shortest s-t path over the arcs with capacity, -1 if t is unreachable
+int st_depth(const Instance& instance) {
+    std::vector<int> depth(instance.n, -1);
+    std::vector<int> queue = {instance.sources[0]};
+    depth[instance.sources[0]] = 0;
+    for (size_t i = 0; i < queue.size(); ++i) {
+        for (const auto& [arc, c] : instance.capacity) {
+            if (arc.first == queue[i] && c > 0 && depth[arc.second] == -1) {
+                depth[arc.second] = depth[queue[i]] + 1;
+                queue.push_back(arc.second);
+            }
+        }
+    }
+    return depth[instance.sinks[0]];
+}
+
+// The features auto selects from must describe the instance (counted here on the
+// arc list), the pick must be one of the candidates, and solving with it must give
+// the reference value; on gengraph 9 it must be capacity scaling (see solver_selection.hpp)
+void check_auto_selection() {
+    generators::Random rng(35);
+    std::vector<Instance> instances;
+    for (int trial = 0; trial < 200; ++trial) instances.push_back(random_instance(rng, 15, 20));
+    instances.push_back(instance_of(generators::generate(1, {6, 6, 100})));
+    instances.push_back(instance_of(generators::generate(4, {10, 3, 100})));
+    instances.push_back(instance_of(generators::generate(9, {40})));
+
+    for (size_t trial = 0; trial < instances.size(); ++trial) {
+        const Instance& instance = instances[trial];
+        Graph graph = build(instance);
+        int s = graph.get_source(), t = graph.get_sink();
+        std::string where = " (trial " + std::to_string(trial) + ")";
+
+        InstanceFeatures features = compute_features(graph, s, t);
+        int m = 0;
+        for (const auto& [arc, c] : instance.capacity) m += c > 0;
+        expect(features.n == instance.n && features.m == m && features.st_depth == st_depth(instance),
+               "features do not describe the instance" + where);
+
+        std::vector<std::string> candidates;
+        for (const std::string& name : default_portfolio) {
+            if (trial % 2 == 0 || rng.integer(0, 1)) candidates.push_back(name);
+        }
+        if (candidates.empty()) candidates.push_back("bfs");
+        std::string name = select_strategy(features, candidates);
+        expect(std::count(candidates.begin(), candidates.end(), name) == 1, name + " is not a candidate" + where);
+
+        FlowState flow(graph);
+        expect(make_solver(name)(graph, flow, s, t) == reference_max_flow(instance), name + " differs from the reference" + where);
+    }
+    const Instance& bad_case_instance = instances.back();
+    InstanceFeatures bad_case = compute_features(build(bad_case_instance), bad_case_instance.sources[0], bad_case_instance.sinks[0]);
+    expect(select_strategy(bad_case) == "scaling", "gengraph 9 no longer selects scaling");
+}
+
+// Distances from `from` over arcs with residual capacity (followed backwards with
+// `reverse`), by a plain queue BFS; -1 for vertices it cannot reach
+std::vector<int> residual_distances(const Graph& graph, const FlowState& flow, int from, bool reverse) {
+    std::vector<int> dist(graph.size(), -1);
+    std::vector<int> queue = {from};
+    dist[from] = 0;
+    for (size_t i = 0; i < queue.size(); ++i) {
+        int u = queue[i];
+        for (const Edge& e : graph.adj(u)) {
+            const Edge& along = reverse ? graph.adj(e.to)[e.rev] : e;
+            if (dist[e.to] == -1 && flow.remaining_capacity(along) > 0) {
+                dist[e.to] = dist[u] + 1;
+                queue.push_back(e.to);
+            }
+        }
+    }
+    return dist;
+}
+
+// Empty if `level` holds the distances of `dist` up to the layer of `to`, and -1
+// beyond it (searches stop after that layer)
+std::string level_error(const std::vector<int>& level, const std::vector<int>& dist, int to) {
+    int last = dist[to] == -1 ? static_cast<int>(dist.size()) : dist[to];
+    for (size_t v = 0; v < dist.size(); ++v) {
+        int expected = dist[v] != -1 && dist[v] <= last ? dist[v] : -1;
+        if (level[v] != expected && !(expected == -1 && level[v] > last)) {
+            return "vertex " + std::to_string(v) + " labelled " + std::to_string(level[v]) + " instead of " + std::to_string(expected);
+        }
+    }
+    return "";
+}
+
+// On a mesh above parallel_bfs::min_parallel_arcs, the search shared by three
+// threads must label every vertex (forwards from s and backwards from t, with t
+// reachable and after a max flow) like a plain BFS, with valid parents; and Dinic
+// and a BFS augmenting path over it must agree with the sequential solve
+void check_parallel_bfs() {
+    constexpr int workers = 3;
+    Graph graph = generators::square_mesh(80, 25, 1000);
+    int s = graph.get_source(), t = graph.get_sink();
+    expect(graph.num_arc_slots() >= parallel_bfs::min_parallel_arcs, "mesh too small for the parallel search");
+
+    FlowState empty(graph), max_flow(graph);
+    int value = dinic_max_flow(graph, max_flow, s, t);
+
+    for (const FlowState* flow : {&empty, &max_flow}) {
+        std::string where = flow == &empty ? " (no flow)" : " (max flow)";
+        for (bool reverse : {false, true}) {
+            int from = reverse ? t : s, to = reverse ? s : t;
+            std::vector<int> level;
+            std::vector<std::pair<int, int>> parent;
+            parallel_bfs::search(graph, *flow, from, to, workers, level, reverse ? nullptr : &parent, nullptr, reverse);
+            std::string error = level_error(level, residual_distances(graph, *flow, from, reverse), to);
+            expect(error.empty(), (reverse ? "reverse search: " : "search: ") + error + where);
+
+            bool parents = true;
+            for (int v = 0; !reverse && v < graph.size(); ++v) {
+                if (v == from || level[v] == -1) continue;
+                auto [u, idx] = parent[v];
+                const Edge& e = graph.adj(u)[idx];
+                parents &= e.to == v && level[u] == level[v] - 1 && flow->remaining_capacity(e) > 0;
+            }
+            expect(parents, "parent arcs do not lead one layer down" + where);
+        }
+    }
+
+    parallel_bfs::set_workers(workers);
+    FlowState flow(graph);
+    int parallel_value = dinic_max_flow(graph, flow, s, t);
+    expect(parallel_value == value, "parallel Dinic differs from the sequential one");
+    std::string error = flow_error(graph, flow, s, t, parallel_value);
+    expect(error.empty(), "parallel Dinic: " + error);
+
+    Path path;
+    FFStats stats;
+    empty.reset();
+    bool found = bfs_path(graph, empty, s, t, path, &stats);
+    bool shortest = found && static_cast<int>(path.size()) == residual_distances(graph, empty, s, false)[t];
+    for (size_t i = 0; shortest && i < path.size(); ++i) {
+        const Edge& e = graph.adj(path[i].first)[path[i].second];
+        int next = i + 1 < path.size() ? path[i + 1].first : t;
+        shortest &= (i > 0 || path[i].first == s) && e.to == next && empty.remaining_capacity(e) > 0;
+    }
+    expect(shortest, "parallel bfs_path did not return a shortest s-t path");
+    parallel_bfs::set_workers(1);
+}
+
+// Pushes up to `paths` shortest augmenting paths, so searches also run on a
+// residual graph with saturated arcs and reverse arcs opened by the flow
+void push_paths(const Graph& graph, FlowState& flow, int s, int t, int paths) {
+    Path path;
+    FFStats stats;
+    for (int i = 0; i < paths && bfs_path(graph, flow, s, t, path, &stats); ++i) {
+        int amount = std::numeric_limits<int>::max();
+        for (auto [u, idx] : path) amount = std::min(amount, flow.remaining_capacity(graph.adj(u)[idx]));
+        for (auto [u, idx] : path) {
+            const Edge& e = graph.adj(u)[idx];
+            flow.augment(e, graph.adj(e.to)[e.rev], amount);
+        }
+    }
+}
+
+// Sparse and dense random instances plus a generated mesh and level graph, for the
+// BFS label checks
+std::vector<Instance> search_instances(generators::Random& rng) {
+    std::vector<Instance> instances;
+    for (int trial = 0; trial < 300; ++trial) {
+        Instance instance = random_instance(rng, 30, 20);
+        if (trial % 2 == 1) {
+            for (int i = 0; i < 5 * instance.n; ++i) {
+                int u = rng.integer(0, instance.n - 1), v = rng.integer(0, instance.n - 1);
+                if (u != v) instance.capacity[{u, v}] += rng.integer(1, 20);
+            }
+        }
+        instances.push_back(instance);
+    }
+    instances.push_back(instance_of(generators::generate(1, {12, 12, 100})));
+    instances.push_back(instance_of(generators::generate(3, {8, 8, 100})));
+    return instances;
+}
+
+// The direction-optimizing bfs_level must label every vertex up to the layer of t
+// like a plain BFS, whichever mix of top-down and bottom-up steps it takes, on
+// each of search_instances before, during and after a max flow
+void check_bfs_level() {
+    generators::Random rng(37);
+    std::vector<Instance> instances = search_instances(rng);
+    for (size_t trial = 0; trial < instances.size(); ++trial) {
+        Graph graph = build(instances[trial]);
+        int s = graph.get_source(), t = graph.get_sink();
+        FlowState flow(graph);
+        for (int paths : {0, rng.integer(1, 4), std::numeric_limits<int>::max()}) {
+            push_paths(graph, flow, s, t, paths);
+            std::vector<int> level;
+            bool reached = bfs_level(graph, flow, level, s, t);
+            std::vector<int> dist = residual_distances(graph, flow, s, false);
+            std::string where = " (trial " + std::to_string(trial) + ")";
+            expect(reached == (dist[t] != -1), "bfs_level reports t wrongly" + where);
+            std::string error = level_error(level, dist, t);
+            expect(error.empty(), "bfs_level: " + error + where);
+        }
+    }
+}
+
+// The same for the reverse search behind Dinic's global relabeling: bfs_dist_to_sink
+// must give every vertex up to the layer of s its residual distance to t. Dinic on
+// top of these labels must still match the reference.
+void check_dist_to_sink() {
+    generators::Random rng(38);
+    std::vector<Instance> instances = search_instances(rng);
+    for (size_t trial = 0; trial < instances.size(); ++trial) {
+        Graph graph = build(instances[trial]);
+        int s = graph.get_source(), t = graph.get_sink();
+        FlowState flow(graph);
+        std::string where = " (trial " + std::to_string(trial) + ")";
+        for (int paths : {0, rng.integer(1, 4), std::numeric_limits<int>::max()}) {
+            push_paths(graph, flow, s, t, paths);
+            std::vector<int> dist;
+            bool reached = bfs_dist_to_sink(graph, flow, dist, s, t);
+            std::vector<int> reference = residual_distances(graph, flow, t, true);
+            expect(reached == (reference[s] != -1), "bfs_dist_to_sink reports s wrongly" + where);
+            std::string error = level_error(dist, reference, s);
+            expect(error.empty(), "bfs_dist_to_sink: " + error + where);
+        }
+
+        flow.reset();
+        int value = dinic_max_flow(graph, flow, s, t);
+        expect(value == reference_max_flow(instances[trial]), "Dinic differs from the reference" + where);
+        std::string error = flow_error(graph, flow, s, t, value);
+        expect(error.empty(), "Dinic: " + error + where);
+    }
+}
+
+// Vertices reachable from s that can also reach t over arcs with capacity, plus s
+// and t themselves (prune_graph keeps them even when t is unreachable)
+std::vector<char> on_st_path(const Graph& graph) {
+    auto reach = [&](int from, bool reverse) {
+        std::vector<char> seen(graph.size(), 0);
+        std::vector<int> queue = {from};
+        seen[from] = 1;
+        for (size_t i = 0; i < queue.size(); ++i) {
+            for (const Edge& e : graph.adj(queue[i])) {
+                long long c = reverse ? graph.adj(e.to)[e.rev].capacity : e.capacity;
+                if (!seen[e.to] && c > 0) {
+                    seen[e.to] = 1;
+                    queue.push_back(e.to);
+                }
+            }
+        }
+        return seen;
+    };
+    std::vector<char> from_s = reach(graph.get_source(), false), to_t = reach(graph.get_sink(), true);
+    for (int v = 0; v < graph.size(); ++v) from_s[v] &= to_t[v];
+    from_s[graph.get_source()] = from_s[graph.get_sink()] = 1;
+    return from_s;
+}
+
+// Prunes random instances (sparse ones, with single and multiple terminals, so many
+// vertices are dead ends), solves the pruned graph and maps the flow back: only s,
+// t and vertices on some s-t path may be kept, each once, and the mapped flow must
+// be a feasible flow of the input graph with the reference value
+void check_prune() {
+    generators::Random rng(39);
+    int pruned_instances = 0;
+    for (int trial = 0; trial < 400; ++trial) {
+        Instance instance = trial % 2 ? random_multi_terminal_instance(rng) : random_instance(rng, 20, 20);
+        Graph graph = build(instance);
+        int s = graph.get_source(), t = graph.get_sink();
+        std::string where = " (trial " + std::to_string(trial) + ")";
+
+        PrunedGraph pruned;
+        if (!prune_graph(graph, pruned)) {
+            expect(on_st_path(graph) == std::vector<char>(graph.size(), 1), "prune_graph kept a dead vertex" + where);
+            continue;
+        }
+        ++pruned_instances;
+
+        std::vector<char> live = on_st_path(graph), kept(graph.size(), 0);
+        bool valid = pruned.original.size() == static_cast<size_t>(pruned.graph.size());
+        for (int v : pruned.original) {
+            valid &= live[v] && !kept[v];
+            kept[v] = 1;
+        }
+        valid &= pruned.original[pruned.graph.get_source()] == s && pruned.original[pruned.graph.get_sink()] == t;
+        expect(valid, "pruned vertices are not distinct vertices on s-t paths" + where);
+
+        FlowState pruned_flow(pruned.graph), flow(graph);
+        int value = dinic_max_flow(pruned.graph, pruned_flow, pruned.graph.get_source(), pruned.graph.get_sink());
+        expect(value == reference_max_flow(instance), "pruned value differs from the reference" + where);
+        map_flow_back(graph, pruned, pruned_flow, flow);
+        std::string error = flow_error(graph, flow, s, t, value);
+        expect(error.empty(), "mapped flow: " + error + where);
+    }
+    expect(pruned_instances > 100, "too few instances were pruned");
+}
+
+// Contracts random instances whose arcs are partly split into chains of one to
+// three new vertices, solves the reduced graph and maps the flow back: the reduced
+// value must match the reference and the mapped flow must be a feasible flow of the
+// input graph with that value
+void check_reduce() {
+    generators::Random rng(40);
+    int reduced_instances = 0;
+    for (int trial = 0; trial < 400; ++trial) {
+        Instance instance = random_instance(rng, 15, 20);
+        Instance chained = instance;
+        chained.capacity.clear();
+        for (const auto& [arc, c] : instance.capacity) {
+            int u = arc.first;
+            for (int i = rng.integer(0, 1) ? rng.integer(1, 3) : 0; i > 0; --i) {
+                chained.capacity[{u, chained.n}] += rng.integer(1, 20);
+                u = chained.n++;
+            }
+            chained.capacity[{u, arc.second}] += c;
+        }
+        Graph graph = build(chained);
+        int s = graph.get_source(), t = graph.get_sink();
+        std::string where = " (trial " + std::to_string(trial) + ")";
+
+        ReducedGraph reduced;
+        if (!reduce_graph(graph, reduced)) continue;
+        ++reduced_instances;
+        expect(reduced.graph.size() < graph.size() || reduced.graph.num_edges() < graph.num_edges(),
+               "reduce_graph reported a contraction but the graph did not shrink" + where);
+
+        FlowState reduced_flow(reduced.graph), flow(graph);
+        int value = dinic_max_flow(reduced.graph, reduced_flow, reduced.graph.get_source(), reduced.graph.get_sink());
+        expect(value == reference_max_flow(chained), "reduced value differs from the reference" + where);
+        map_flow_back(graph, reduced, reduced_flow, flow);
+        std::string error = flow_error(graph, flow, s, t, value);
+        expect(error.empty(), "mapped flow: " + error + where);
+    }
+    expect(reduced_instances > 200, "too few instances were reduced");
+}
+
+// Relabels random instances (with single and multiple terminals) in BFS and RCM
+// order: the new ids must be a permutation (starting at s for BFS), every arc must
+// keep its capacity under it, adjacency lists must be sorted by neighbour id, and
+// the flow of the relabelled graph, mapped back, must be a feasible flow of the
+// input graph with the reference value
+void check_reorder() {
+    generators::Random rng(41);
+    for (int trial = 0; trial < 300; ++trial) {
+        Instance instance = trial % 2 ? random_multi_terminal_instance(rng) : random_instance(rng, 25, 20);
+        Graph graph = build(instance);
+        int s = graph.get_source(), t = graph.get_sink();
+        Instance arcs = instance_of(graph);
+
+        for (VertexOrder order : {VertexOrder::BFS, VertexOrder::RCM}) {
+            std::string where = std::string(order == VertexOrder::BFS ? " (bfs" : " (rcm") + ", trial " + std::to_string(trial) + ")";
+            PrunedGraph reordered = reorder_graph(graph, order);
+            const Graph& relabelled = reordered.graph;
+
+            std::vector<int> sorted = reordered.original;
+            std::sort(sorted.begin(), sorted.end());
+            bool permutation = relabelled.size() == graph.size() && static_cast<int>(sorted.size()) == graph.size();
+            for (int v = 0; permutation && v < graph.size(); ++v) permutation = sorted[v] == v;
+            expect(permutation && (order == VertexOrder::RCM || reordered.original[0] == s),
+                   "new ids are not a permutation of the vertices" + where);
+            if (!permutation) continue;
+            expect(reordered.original[relabelled.get_source()] == s && reordered.original[relabelled.get_sink()] == t,
+                   "terminals moved" + where);
+
+            Instance mapped = instance_of(relabelled);
+            std::map<std::pair<int, int>, long long> capacity;
+            for (const auto& [arc, c] : mapped.capacity) capacity[{reordered.original[arc.first], reordered.original[arc.second]}] = c;
+            expect(capacity == arcs.capacity, "arc capacities changed" + where);
+
+            bool ordered = true;
+            for (int u = 0; u < relabelled.size(); ++u) {
+                const auto& list = relabelled.adj(u);
+                ordered &= std::is_sorted(list.begin(), list.end(), [](const Edge& a, const Edge& b) { return a.to < b.to; });
+            }
+            expect(ordered, "adjacency lists are not sorted by neighbour id" + where);
+
+            FlowState reordered_flow(relabelled), flow(graph);
+            int value = dinic_max_flow(relabelled, reordered_flow, relabelled.get_source(), relabelled.get_sink());
+            expect(value == reference_max_flow(instance), "relabelled value differs from the reference" + where);
+            map_flow_back(graph, reordered, reordered_flow, flow);
+            std::string error = flow_error(graph, flow, s, t, value);
+            expect(error.empty(), "mapped flow: " + error + where);
+        }
+    }
+}
+
+// Reads random instances from DIMACS text, a third with small capacities and the
+// rest scaled by up to 2^32, with single terminals and with terminal sets:
+// small inputs must stay int, an arc above 2^31-1 must widen the graph, an int
+// graph must hold all its flows (fits_in), and the value in either type must match
+// the 64-bit reference with a feasible flow. An int flow converted to 64 bits must
+// stay the same flow of the widened graph.
+void check_wide_capacities() {
+    generators::Random rng(42);
+    int wide_instances = 0;
+    for (int trial = 0; trial < 300; ++trial) {
+        Instance instance = trial % 2 ? random_multi_terminal_instance(rng) : random_instance(rng, 15, 20);
+        long long largest = 0;
+        if (trial % 3 != 0) {
+            for (auto& [arc, c] : instance.capacity) {
+                c *= 1LL << rng.integer(20, 32);
+                largest = std::max(largest, c);
+            }
+        }
+        std::istringstream in(to_dimacs(instance));
+        InputGraph input = read_graph(in);
+        long long expected = reference_max_flow(instance);
+        std::string where = " (trial " + std::to_string(trial) + ")";
+
+        if (trial % 3 == 0) expect(!input.is_wide, "small capacities were widened" + where);
+        if (largest > std::numeric_limits<int>::max()) expect(input.is_wide, "an arc above 2^31-1 was kept as int" + where);
+
+        if (input.is_wide) {
+            ++wide_instances;
+            const Graph64& graph = input.wide;
+            FlowState64 flow(graph);
+            long long value = dinic_max_flow(graph, flow, graph.get_source(), graph.get_sink());
+            expect(value == expected, "64-bit value differs from the reference" + where);
+            std::string error = flow_error(graph, flow, graph.get_source(), graph.get_sink(), value);
+            expect(error.empty(), "64-bit flow: " + error + where);
+            continue;
+        }
+
+        const Graph& graph = input.graph;
+        int s = graph.get_source(), t = graph.get_sink();
+        expect(fits_in<int>(graph), "an int graph does not hold its flows" + where);
+        FlowState flow(graph);
+        int value = dinic_max_flow(graph, flow, s, t);
+        expect(value == expected, "int value differs from the reference" + where);
+        std::string error = flow_error(graph, flow, s, t, value);
+        expect(error.empty(), "int flow: " + error + where);
+
+        Graph64 wide(graph);
+        FlowState64 converted = flow.convert<long long>();
+        error = flow_error(wide, converted, s, t, static_cast<long long>(value));
+        expect(error.empty(), "converted flow: " + error + where);
+    }
+    expect(wide_instances > 50, "too few instances were widened");
+}
+
+// Feeds compress_graph random arcs with duplicates, both directions of a pair and
+// arcs without capacity, then more arcs for a second compress_graph over the built
+// block: the result must hold one pair per connected couple of vertices (and two
+// flow slots per pair, nothing more) with the summed capacities, and solve to the
+// reference value
+void check_compress() {
+    generators::Random rng(44);
+    for (int trial = 0; trial < 300; ++trial) {
+        Instance instance;
+        instance.n = rng.integer(2, 20);
+        instance.sinks = {instance.n - 1};
+        Graph graph(instance.n);
+        std::string where = " (trial " + std::to_string(trial) + ")";
+
+        for (int round = 0; round < 2; ++round) {
+            for (int i = rng.integer(0, 4 * instance.n); i > 0; --i) {
+                int u = rng.integer(0, instance.n - 1), v = rng.integer(0, instance.n - 1);
+                int c = rng.integer(-2, 20);
+                if (u == v) continue;
+                if (c > 0) instance.capacity[{u, v}] += c;
+                graph.add_edge(u, v, c);
+                if (rng.integer(0, 3) == 0) { // the same arc again, to be merged
+                    if (c > 0) instance.capacity[{u, v}] += c;
+                    graph.add_edge(u, v, c);
+                }
+            }
+            graph.compress_graph();
+
+            std::map<std::pair<int, int>, int> pairs;
+            for (const auto& [arc, c] : instance.capacity) ++pairs[{std::min(arc.first, arc.second), std::max(arc.first, arc.second)}];
+            expect(graph.num_arc_slots() == 2 * static_cast<int>(pairs.size()), "flow slots not packed" + where);
+            std::string error = structure_error(graph, instance);
+            expect(error.empty(), error + " after compress " + std::to_string(round + 1) + where);
+        }
+
+        graph.set_terminals(instance.sources, instance.sinks);
+        FlowState flow(graph);
+        int value = dinic_max_flow(graph, flow, graph.get_source(), graph.get_sink());
+        expect(value == reference_max_flow(instance), "compressed graph differs from the reference" + where);
+    }
+}
+
+// Builds and solves a mesh whose arc and flow arrays span several huge pages in
+// every huge_pages mode: the graph and the flow must come out the same as with
+// regular allocation, and directly mapped blocks must be huge page aligned and
+// writable to their last byte
+void check_huge_pages() {
+    using huge_pages::Mode;
+    huge_pages::set_mode(Mode::Default);
+    Graph reference_graph = generators::square_mesh(80, 25, 1000);
+    FlowState reference_flow(reference_graph);
+    int s = reference_graph.get_source(), t = reference_graph.get_sink();
+    int value = dinic_max_flow(reference_graph, reference_flow, s, t);
+    expect(reference_graph.num_arc_slots() * sizeof(Edge) > 2 * huge_pages::page_size, "mesh smaller than two huge pages");
+
+    for (Mode mode : {Mode::Off, Mode::Transparent, Mode::Explicit}) {
+        std::string where = " (" + std::string(mode == Mode::Off ? "off" : mode == Mode::Transparent ? "thp" : "explicit") + ")";
+        huge_pages::set_mode(mode);
+
+        size_t bytes = 3 * huge_pages::page_size + 1;
+        char* block = static_cast<char*>(huge_pages::allocate(bytes));
+        block[0] = block[bytes - 1] = 1;
+#ifdef __linux__
+        expect(reinterpret_cast<uintptr_t>(block) % huge_pages::page_size == 0, "block not huge page aligned" + where);
+#endif
+        huge_pages::deallocate(block, bytes);
+
+        Graph graph = generators::square_mesh(80, 25, 1000);
+        FlowState flow(graph);
+        expect(snapshot(graph) == snapshot(reference_graph), "graph differs from the regular one" + where);
+        expect(dinic_max_flow(graph, flow, s, t) == value, "value differs from the regular one" + where);
+        bool same = true;
+        for (int u = 0; u < graph.size(); ++u) {
+            for (const Edge& e : graph.adj(u)) same &= flow.flow(e) == reference_flow.flow(e);
+        }
+        expect(same, "flow differs from the regular one" + where);
+    }
+    huge_pages::set_mode(Mode::Default);
+}
+
+// Runs the same work with NUMA interleaving off and on: a mesh solved by the
+// parallel search, a widened graph read from DIMACS (whose 64-bit copy and flow
+// arrays are interleaved too) and batch queries on pool workers must all give the
+// same graphs and results. allocate_interleaved must leave exactly `count` zeroed
+// elements. On a single node interleaving is a no-op, so this mostly guards the
+// code paths it takes.
+void check_numa() {
+    generators::Random rng(46);
+    Instance wide = random_multi_terminal_instance(rng);
+    wide.capacity[{wide.sources[0], wide.sinks[0]}] += 1;
+    for (auto& [arc, c] : wide.capacity) c <<= 31;
+    Instance small = random_instance(rng, 12, 20);
+    std::ostringstream file;
+    for (int s = 0; s < small.n; ++s) {
+        for (int t = 0; t < small.n; ++t) {
+            if (s != t) file << s + 1 << " " << t + 1 << "\n";
+        }
+    }
+
+    std::vector<std::string> runs;
+    for (bool enabled : {false, true}) {
+        numa::set_interleave(enabled);
+        std::ostringstream run;
+
+        parallel_bfs::set_workers(3);
+        Graph mesh = generators::square_mesh(80, 25, 1000);
+        FlowState flow(mesh);
+        run << snapshot(mesh).size() << " " << dinic_max_flow(mesh, flow, mesh.get_source(), mesh.get_sink()) << "\n";
+        parallel_bfs::set_workers(1);
+
+        std::istringstream in(to_dimacs(wide));
+        InputGraph input = read_graph(in);
+        FlowState64 flow64(input.wide);
+        run << input.is_wide << " " << dinic_max_flow(input.wide, flow64, input.wide.get_source(), input.wide.get_sink()) << "\n";
+
+        Graph graph = build(small);
+        std::istringstream queries(file.str());
+        solve_batch(graph, read_queries(queries, small.n), make_solver("dinics"), 3, run);
+        runs.push_back(run.str());
+    }
+    numa::set_interleave(false);
+    expect(runs[0] == runs[1], "results change with interleaving");
+    expect(runs[1].find("1 " + std::to_string(reference_max_flow(wide)) + "\n") != std::string::npos,
+           "interleaved 64-bit graph differs from the reference");
+
+    std::vector<int> v(10, 7);
+    numa::allocate_interleaved(v, 5);
+    expect(v == std::vector<int>(5, 0), "allocate_interleaved kept old contents");
+}
+
+// Every numbered family must build the same graph as reading the file bin/gengraph
+// writes for it (so type 3 stays RLevel, as in new_washington.c), and type 12 must
+// be random_2level, which differs from it
+void check_generators() {
+    const std::vector<std::pair<int, std::vector<int>>> families = {
+        {1, {6, 5, 100}}, {2, {6, 5, 100}}, {3, {6, 6, 100}}, {4, {30, 4, 100}}, {5, {6, 3, 100}},
+        {6, {8, 6, 3, 100}}, {7, {8, 6, 3, 100}}, {8, {8, 6, 3, 100}}, {9, {20}}, {10, {20}}, {11, {10, 3, 3, 100}},
+    };
+    std::string path = "bin/correctness_gengraph.dimacs";
+    for (const auto& [type, params] : families) {
+        std::string command = "bin/gengraph " + std::to_string(type);
+        for (int p : params) command += " " + std::to_string(p);
+        std::string where = " (" + command + ")";
+        if (std::system((command + " " + path + " > /dev/null").c_str()) != 0) {
+            expect(false, "could not run" + where);
+            continue;
+        }
+        std::ifstream file(path);
+        InputGraph input = read_graph(file);
+        Graph graph = generators::generate(type, params);
+        expect(snapshot(graph) == snapshot(input.graph) && graph.get_source() == input.graph.get_source() &&
+                   graph.get_sink() == input.graph.get_sink(),
+               "generate differs from the gengraph file" + where);
+    }
+    std::remove(path.c_str());
+
+    Graph two_level = generators::generate(12, {6, 6, 100});
+    expect(snapshot(two_level) == snapshot(generators::random_2level(6, 6, 100)), "type 12 is not random_2level");
+    expect(snapshot(two_level) != snapshot(generators::generate(3, {6, 6, 100})), "type 12 builds the type 3 graph");
+}
+
+// Parses a CSR file field by field (see csr.hpp), without Graph::read_csr.
+// Returns false if the header or the offsets are malformed.
+bool read_csr_instance(const std::string& path, Instance& instance) {
+    std::ifstream in(path, std::ios::binary);
+    csr::Header header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in || !std::equal(header.magic, header.magic + 8, csr::magic) || header.source >= header.n || header.sink >= header.n) {
+        return false;
+    }
+    std::vector<uint64_t> first(header.n + 1);
+    std::vector<uint32_t> heads(header.m);
+    std::vector<int32_t> capacities(header.m);
+    in.read(reinterpret_cast<char*>(first.data()), first.size() * sizeof(uint64_t));
+    in.read(reinterpret_cast<char*>(heads.data()), heads.size() * sizeof(uint32_t));
+    in.read(reinterpret_cast<char*>(capacities.data()), capacities.size() * sizeof(int32_t));
+    if (!in || in.peek() != EOF || first[0] != 0 || first[header.n] != header.m) return false;
+
+    instance = Instance();
+    instance.n = static_cast<int>(header.n);
+    instance.sources = {static_cast<int>(header.source)};
+    instance.sinks = {static_cast<int>(header.sink)};
+    for (uint64_t u = 0; u < header.n; ++u) {
+        if (first[u] > first[u + 1]) return false;
+        for (uint64_t i = first[u]; i < first[u + 1]; ++i) {
+            if (heads[i] >= header.n || capacities[i] < 0) return false;
+            if (heads[i] != u && capacities[i] > 0) instance.capacity[{static_cast<int>(u), static_cast<int>(heads[i])}] += capacities[i];
+        }
+    }
+    return true;
+}
+
+std::string file_bytes(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream bytes;
+    bytes << in.rdbuf();
+    return bytes.str();
+}
+
+// Writes mesh, random level and matching graphs with one and with three workers
+// (the larger ones span several blocks of vertices): the files must be identical
+// and have the header describe() announces, and read_graph must load them as the
+// graph of an independent parse of the file; the small ones must also solve to the
+// reference value
+void check_csr() {
+    using parallel_generator::Family;
+    const std::vector<Family> families = {
+        {1, {6, 5, 100}}, {2, {6, 5, 100}}, {4, {30, 4, 100}},
+        {1, {300, 300, 100}}, {2, {300, 300, 100}}, {4, {70000, 3, 100}},
+    };
+    std::string one = "bin/correctness_1.csr", three = "bin/correctness_3.csr";
+    for (size_t i = 0; i < families.size(); ++i) {
+        const Family& family = families[i];
+        std::string where = " (family " + std::to_string(family.type) + ", graph " + std::to_string(i) + ")";
+        uint64_t seed = 7 + i;
+        csr::Header header = parallel_generator::write_csr(family, seed, 1, one);
+        parallel_generator::write_csr(family, seed, 3, three);
+        csr::Header described = parallel_generator::describe(family);
+        expect(header.n == described.n && header.m == described.m && header.source == described.source &&
+                   header.sink == described.sink,
+               "header differs from describe()" + where);
+        std::string bytes = file_bytes(one);
+        expect(!bytes.empty() && bytes == file_bytes(three), "files differ between 1 and 3 workers" + where);
+
+        Instance instance;
+        if (!read_csr_instance(one, instance)) {
+            expect(false, "malformed file" + where);
+            continue;
+        }
+        std::istringstream in(bytes);
+        InputGraph input = read_graph(in);
+        std::string error = input.is_wide ? "widened" : structure_error(input.graph, instance);
+        expect(error.empty(), "read_graph: " + error + where);
+        expect(!input.is_wide && input.graph.get_source() == instance.sources[0] && input.graph.get_sink() == instance.sinks[0],
+               "read_graph moved the terminals" + where);
+
+        if (instance.n <= 200 && !input.is_wide) {
+            FlowState flow(input.graph);
+            int value = dinic_max_flow(input.graph, flow, input.graph.get_source(), input.graph.get_sink());
+            expect(value == reference_max_flow(instance), "value differs from the reference" + where);
+        }
+    }
+    std::remove(one.c_str());
+    std::remove(three.c_str());
+}
+
+// Replays Edmonds-Karp with bfs_path on random instances (antiparallel arcs and
+// cancelled flow included), counting each saturated arc at the lower flow slot of
+// its pair: ford_fulkerson must report the same counts (none at odd slots), one
+// counter per flow slot, and cFrac over them
+void check_critical_arcs() {
+    generators::Random rng(43);
+    for (int trial = 0; trial < 300; ++trial) {
+        Instance instance = random_instance(rng, 20, 20);
+        Graph graph = build(instance);
+        int s = graph.get_source(), t = graph.get_sink();
+        std::string where = " (trial " + std::to_string(trial) + ")";
+
+        FlowState flow(graph);
+        FFStats stats;
+        int value = ford_fulkerson(graph, flow, s, t, BasicPathFindingStrategy<int>(bfs_path<int>), AlgorithmType::BFS_EDMONDS_KARP, &stats);
+        expect(value == reference_max_flow(instance), "value differs from the reference" + where);
+
+        FlowState replay(graph);
+        std::vector<int> critical(graph.num_arc_slots(), 0);
+        Path path;
+        FFStats path_stats;
+        int iterations = 0;
+        for (; bfs_path(graph, replay, s, t, path, &path_stats); ++iterations) {
+            int amount = std::numeric_limits<int>::max();
+            for (auto [u, idx] : path) amount = std::min(amount, replay.remaining_capacity(graph.adj(u)[idx]));
+            for (auto [u, idx] : path) {
+                const Edge& e = graph.adj(u)[idx];
+                const Edge& r = graph.adj(e.to)[e.rev];
+                if (replay.remaining_capacity(e) == amount) ++critical[std::min(e.arc, r.arc)];
+                replay.augment(e, r, amount);
+            }
+        }
+        expect(stats.iterations == iterations && stats.criticalCount == critical, "critical arcs counted differently" + where);
+        int saturated = static_cast<int>(critical.size()) - static_cast<int>(std::count(critical.begin(), critical.end(), 0));
+        expect(critical.empty() || stats.cFrac == static_cast<double>(saturated) / critical.size(), "cFrac off" + where);
+    }
+}
+
+} // namespace
+
+int main() {
+    const std::vector<std::pair<std::string, std::function<void()>>> checks = {
+        {"warm_start", check_warm_start},
+        {"dynamic_arcs", check_dynamic_arcs},
+        {"min_cut", check_min_cut},
+        {"flow_decomposition", check_flow_decomposition},
+        {"multi_terminal", check_multi_terminal},
+        {"gomory_hu", check_gomory_hu},
+        {"batch", check_batch},
+        {"shared_graph", check_shared_graph},
+        {"portfolio", check_portfolio},
+        {"auto_selection", check_auto_selection},
+        {"parallel_bfs", check_parallel_bfs},
+        {"bfs_level", check_bfs_level},
+        {"dist_to_sink", check_dist_to_sink},
+        {"prune", check_prune},
+        {"reduce", check_reduce},
+        {"reorder", check_reorder},
+        {"wide_capacities", check_wide_capacities},
+        {"compress", check_compress},
+        {"huge_pages", check_huge_pages},
+        {"numa", check_numa},
+        {"generators", check_generators},
+        {"csr", check_csr},
+        {"critical_arcs", check_critical_arcs},
+    };
+
+    for (const auto& [name, check] : checks) {
+        int before = failures;
+        check();
+        std::cout << name << ": " << (failures == before ? "ok" : "FAILED") << "\n";
+    }
+    return failures == 0 ? 0 : 1;
+}
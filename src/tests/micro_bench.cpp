@@ -0,0 +1,289 @@
+// Micro-benchmarks of the path-finding kernels and graph construction (make bench).
+// Every kernel runs on the same fixed synthetic graphs, built in memory from a
+// seeded generator, so timings are comparable between builds. Each benchmark is
+// repeated and reported as mean, median, stddev and the 95% confidence half-width
+// of the mean (ci95), which is what tells a real regression from noise.
+#include "graph.hpp"
+#include "flow_state.hpp"
+#include "ford_fulkerson.hpp"
+#include "dinics.hpp"
+#include "find_path_headers/bfs.hpp"
+#include "find_path_headers/dfs_random.hpp"
+#include "find_path_headers/fattest.hpp"
+#include "find_path_headers/capacity_scaling.hpp"
+#include "generators.hpp"
+#include "parallel_bfs.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace {
+    constexpr int levels = 64;      // Layers of the synthetic graphs; the width is the benchmark argument
+    constexpr int out_degree = 3;   // Arcs from each vertex into the next layer
+    constexpr int max_capacity = 1000;
+    constexpr int repetitions = 10;
+
+    // DIMACS text of a random layered graph (like the RLevel family of new_washington.c):
+    // s feeds the first layer, the last layer feeds t
+    std::string layered_dimacs(int width) {
+        std::mt19937 rng(12345);
+        std::uniform_int_distribution<int> cap(1, max_capacity);
+        std::uniform_int_distribution<int> pick(0, width - 1);
+        int n = levels * width + 2;
+        int s = 1, t = n;
+        auto id = [width](int level, int i) { return 2 + level * width + i; };
+
+        std::ostringstream arcs;
+        int m = 0;
+        for (int i = 0; i < width; ++i) {
+            arcs << "a " << s << " " << id(0, i) << " " << cap(rng) << "\n";
+            arcs << "a " << id(levels - 1, i) << " " << t << " " << cap(rng) << "\n";
+            m += 2;
+        }
+        for (int level = 0; level + 1 < levels; ++level) {
+            for (int i = 0; i < width; ++i) {
+                for (int k = 0; k < out_degree; ++k) {
+                    arcs << "a " << id(level, i) << " " << id(level + 1, pick(rng)) << " " << cap(rng) << "\n";
+                    ++m;
+                }
+            }
+        }
+
+        std::ostringstream out;
+        out << "p max " << n << " " << m << "\nn " << s << " s\nn " << t << " t\n" << arcs.str();
+        return out.str();
+    }
+
+    // Graphs are built once per width and shared by every benchmark
+    const std::string& dimacs(int width) {
+        static std::map<int, std::string> cache;
+        auto it = cache.find(width);
+        if (it == cache.end()) it = cache.emplace(width, layered_dimacs(width)).first;
+        return it->second;
+    }
+
+    const Graph& graph(int width) {
+        static std::map<int, Graph> cache;
+        auto it = cache.find(width);
+        if (it == cache.end()) {
+            std::istringstream in(dimacs(width));
+            Graph g;
+            g.read_dimacs(in);
+            it = cache.emplace(width, std::move(g)).first;
+        }
+        return it->second;
+    }
+
+    // Half-width of the 95% confidence interval of the mean (Student's t)
+    double ci95(const std::vector<double>& v) {
+        static const double t_table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                         2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086};
+        size_t n = v.size();
+        if (n < 2) return 0.0;
+        double mean = 0.0;
+        for (double x : v) mean += x;
+        mean /= n;
+        double var = 0.0;
+        for (double x : v) var += (x - mean) * (x - mean);
+        var /= (n - 1);
+        double t = (n - 1 <= 20) ? t_table[n - 2] : 1.96;
+        return t * std::sqrt(var / n);
+    }
+
+    // Per-search vectors of FFStats grow on every call; only the last search matters here
+    void clear_search_stats(FFStats& stats) {
+        stats.visited_nodes_per_iter.clear();
+        stats.visited_forward_arcs_per_iter.clear();
+        stats.visited_residual_arcs_per_iter.clear();
+        stats.heap_real_inserts_per_iter.clear();
+        stats.heap_implicit_updates_per_iter.clear();
+        stats.heap_total_inserts_per_iter.clear();
+        stats.heap_deleteMins_per_iter.clear();
+    }
+
+    // One search for an s-t path on the zero flow, as in the first Ford-Fulkerson iteration
+    void bench_path(benchmark::State& state, PathFindingStrategy find_path) {
+        const Graph& g = graph(state.range(0));
+        FlowState flow(g);
+        FFStats stats;
+        Path path;
+        for (auto _ : state) {
+            stats.max_cap_initialized = false; // capacity scaling starts over from the largest delta
+            clear_search_stats(stats);
+            benchmark::DoNotOptimize(find_path(g, flow, g.get_source(), g.get_sink(), path, &stats));
+        }
+        state.SetItemsProcessed(state.iterations() * g.num_edges_residual());
+    }
+} // namespace
+
+static void BM_bfs_path(benchmark::State& state) { bench_path(state, bfs_path<int>); }
+static void BM_dfs_path(benchmark::State& state) { bench_path(state, dfs_path<int>); }
+static void BM_fattest_path(benchmark::State& state) { bench_path(state, fattest_path<int>); }
+static void BM_capacity_scaling_path(benchmark::State& state) { bench_path(state, capacity_scaling_path<int>); }
+
+// Augments along a BFS path and takes the flow back, so every iteration sees the same flow
+static void BM_augment(benchmark::State& state) {
+    const Graph& g = graph(state.range(0));
+    FlowState flow(g);
+    FFStats stats;
+    stats.criticalCount.assign(g.num_arc_slots(), 0);
+    Path path;
+    bfs_path(g, flow, g.get_source(), g.get_sink(), path, &stats);
+
+    for (auto _ : state) {
+        int pushed = augment(g, flow, path, &stats);
+        for (const auto& [u, idx] : path) {
+            const Edge& e = g.adj(u)[idx];
+            flow.augment(e, g.adj(e.to)[e.rev], -pushed);
+        }
+    }
+    state.counters["path_length"] = static_cast<double>(path.size());
+}
+
+// Level labels of one Dinic phase on the zero flow
+static void BM_bfs_level(benchmark::State& state) {
+    const Graph& g = graph(state.range(0));
+    FlowState flow(g);
+    std::vector<int> level;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bfs_level(g, flow, level, g.get_source(), g.get_sink()));
+    }
+    state.SetItemsProcessed(state.iterations() * g.num_edges_residual());
+}
+
+// Blocking flow of the first Dinic phase: dfs_flow until it finds nothing
+static void BM_dfs_flow(benchmark::State& state) {
+    const Graph& g = graph(state.range(0));
+    int s = g.get_source(), t = g.get_sink();
+    FlowState flow(g);
+    std::vector<int> dist, ptr;
+    bfs_dist_to_sink(g, flow, dist, s, t);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        flow.reset();
+        ptr.assign(g.size(), 0);
+        state.ResumeTiming();
+        while (int pushed = dfs_flow(g, flow, dist, ptr, s, t, std::numeric_limits<int>::max())) {
+            benchmark::DoNotOptimize(pushed);
+        }
+    }
+}
+
+static void BM_read_dimacs(benchmark::State& state) {
+    const std::string& text = dimacs(state.range(0));
+    for (auto _ : state) {
+        std::istringstream in(text);
+        Graph g;
+        g.read_dimacs(in);
+        benchmark::DoNotOptimize(g.size());
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+// compress_graph alone: the arcs are recorded with add_edge outside the timed part
+static void BM_compress_graph(benchmark::State& state) {
+    const Graph& source = graph(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        Graph g(source.size());
+        for (int u = 0; u < source.size(); ++u) {
+            for (const Edge& e : source.adj(u)) {
+                if (e.capacity > 0) g.add_edge(u, e.to, e.capacity);
+            }
+        }
+        state.ResumeTiming();
+        g.compress_graph();
+        benchmark::DoNotOptimize(g.num_arc_slots());
+    }
+}
+
+// Size sweeps over a gengraph family, built in memory (no DIMACS file or parsing)
+static void BM_generate_square_mesh(benchmark::State& state) {
+    for (auto _ : state) {
+        Graph g = generators::square_mesh(state.range(0), 25, max_capacity);
+        benchmark::DoNotOptimize(g.num_arc_slots());
+    }
+}
+
+static void BM_dinic_square_mesh(benchmark::State& state) {
+    Graph g = generators::square_mesh(state.range(0), 25, max_capacity);
+    FlowState flow(g);
+    DinicStats stats;
+    for (auto _ : state) {
+        state.PauseTiming();
+        flow.reset();
+        stats = DinicStats();
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(dinic_max_flow(g, flow, g.get_source(), g.get_sink(), nullptr, nullptr, &stats));
+    }
+    state.counters["arcs"] = g.num_edges();
+    state.counters["phases"] = stats.phases;
+    state.counters["arc_inspections"] = stats.arc_inspections;
+}
+
+// Dinic with its BFS searches split over range(1) threads (max_flow --threads), on
+// square meshes on both sides of parallel_bfs::min_parallel_arcs. The parallel search
+// only pays off with more hardware threads than one: compare the workers > 1 rows
+// with the workers = 1 row of the same side, and read hardware_threads before
+// concluding anything from them.
+static void BM_dinic_threads(benchmark::State& state) {
+    Graph g = generators::square_mesh(state.range(0), 25, max_capacity);
+    FlowState flow(g);
+    parallel_bfs::set_workers(state.range(1));
+    for (auto _ : state) {
+        state.PauseTiming();
+        flow.reset();
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(dinic_max_flow(g, flow, g.get_source(), g.get_sink()));
+    }
+    parallel_bfs::set_workers(1);
+    state.counters["arc_slots"] = g.num_arc_slots();
+    state.counters["parallel"] = g.num_arc_slots() >= parallel_bfs::min_parallel_arcs;
+    state.counters["hardware_threads"] = std::thread::hardware_concurrency();
+}
+
+#define KERNEL_BENCHMARK(name)                                  \
+    BENCHMARK(name)                                             \
+        ->Arg(256)->Arg(2048)                                   \
+        ->Unit(benchmark::kMicrosecond)                         \
+        ->Repetitions(repetitions)                              \
+        ->ComputeStatistics("ci95", ci95)                       \
+        ->ReportAggregatesOnly(true)
+
+KERNEL_BENCHMARK(BM_bfs_path);
+KERNEL_BENCHMARK(BM_dfs_path);
+KERNEL_BENCHMARK(BM_fattest_path);
+KERNEL_BENCHMARK(BM_capacity_scaling_path);
+KERNEL_BENCHMARK(BM_augment);
+KERNEL_BENCHMARK(BM_bfs_level);
+KERNEL_BENCHMARK(BM_dfs_flow);
+KERNEL_BENCHMARK(BM_read_dimacs);
+KERNEL_BENCHMARK(BM_compress_graph);
+
+#define SWEEP_BENCHMARK(name)                                   \
+    BENCHMARK(name)                                             \
+        ->RangeMultiplier(2)->Range(32, 128)                    \
+        ->Unit(benchmark::kMicrosecond)                         \
+        ->Repetitions(repetitions)                              \
+        ->ComputeStatistics("ci95", ci95)                       \
+        ->ReportAggregatesOnly(true)
+
+SWEEP_BENCHMARK(BM_generate_square_mesh);
+SWEEP_BENCHMARK(BM_dinic_square_mesh);
+
+BENCHMARK(BM_dinic_threads)
+    ->ArgNames({"side", "workers"})
+    ->ArgsProduct({{64, 128, 256}, {1, 2, 4}})
+    ->Unit(benchmark::kMillisecond)
+    ->Repetitions(repetitions)
+    ->ComputeStatistics("ci95", ci95)
+    ->ReportAggregatesOnly(true);
+
+BENCHMARK_MAIN();
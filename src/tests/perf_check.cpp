@@ -0,0 +1,126 @@
+#include "graph.hpp"
+#include "flow_state.hpp"
+#include "ford_fulkerson.hpp"
+#include "dinics.hpp"
+#include "find_path_headers/bfs.hpp"
+#include "find_path_headers/dfs_random.hpp"
+#include "find_path_headers/fattest.hpp"
+#include "find_path_headers/capacity_scaling.hpp"
+#include "generators.hpp"
+#include "solver_selection.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+// Runs every solver on a graph and prints one line per solver:
+//   solver;max_flow;wall_ms;iterations;arc_inspections
+// `perf_check [repetitions]` reads the graph in DIMACS from stdin; with a gengraph
+// family and its parameters (`perf_check 5 5 20 10 1000`) it is built in memory
+// (see generators.hpp). wall_ms is the best of the repetitions (the least noisy estimate). The counters are
+// deterministic (dfs is reseeded before every run), so bash/perfcheck.sh can compare
+// them exactly against results/perfcheck/baseline.csv. A last line repeats the measure of
+// the strategy `max_flow auto` picks for the graph, as solver "auto=<name>", so a change
+// of that choice shows up in the comparison too.
+
+struct StrategyConfig {
+    std::string name;
+    PathFindingStrategy strategy;
+    AlgorithmType type;
+};
+
+struct Measure {
+    long long max_flow = 0;
+    double wall_ms = std::numeric_limits<double>::max();
+    long long iterations = 0;
+    long long arc_inspections = 0;
+};
+
+int num_repetitions = 5;
+constexpr unsigned dfs_seed = 1;
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Ford-Fulkerson: iterations are augmenting paths, arc inspections the residual arcs
+// looked at by all the searches (the strategies' visited_residual_arcs_per_iter)
+static Measure run_ford_fulkerson(const Graph& graph, FlowState& flow, const StrategyConfig& config) {
+    Measure measure;
+    for (int rep = 0; rep < num_repetitions; ++rep) {
+        flow.reset();
+        dfs_random_seed(dfs_seed);
+        FFStats stats;
+
+        auto start = std::chrono::steady_clock::now();
+        measure.max_flow = ford_fulkerson(graph, flow, graph.get_source(), graph.get_sink(), config.strategy, config.type, &stats);
+        measure.wall_ms = std::min(measure.wall_ms, elapsed_ms(start));
+
+        measure.iterations = stats.iterations;
+        measure.arc_inspections = 0;
+        for (int arcs : stats.visited_residual_arcs_per_iter) measure.arc_inspections += arcs;
+    }
+    return measure;
+}
+
+// Dinic: the wall time and counters both come from dinic_max_flow itself (see
+// DinicStats): phases are the iterations, and arc inspections the arcs the
+// current-arc pointers of the blocking-flow DFS moved past.
+static Measure run_dinic(const Graph& graph, FlowState& flow) {
+    int s = graph.get_source(), t = graph.get_sink();
+    Measure measure;
+    DinicStats stats;
+    for (int rep = 0; rep < num_repetitions; ++rep) {
+        flow.reset();
+        stats = DinicStats();
+        auto start = std::chrono::steady_clock::now();
+        measure.max_flow = dinic_max_flow(graph, flow, s, t, nullptr, nullptr, &stats);
+        measure.wall_ms = std::min(measure.wall_ms, elapsed_ms(start));
+    }
+    measure.iterations = stats.phases;
+    measure.arc_inspections = stats.arc_inspections;
+    return measure;
+}
+
+static void print(const std::string& name, const Measure& measure) {
+    std::cout << name << ";" << measure.max_flow << ";" << std::fixed << std::setprecision(3) << measure.wall_ms
+              << ";" << measure.iterations << ";" << measure.arc_inspections << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) num_repetitions = std::max(1, std::stoi(argv[1]));
+
+    std::vector<StrategyConfig> strategies = {
+        {"bfs", bfs_path<int>, AlgorithmType::BFS_EDMONDS_KARP},
+        {"dfs", dfs_path<int>, AlgorithmType::DFS_RANDOM},
+        {"fat", fattest_path<int>, AlgorithmType::FATTEST_PATH},
+        {"scaling", capacity_scaling_path<int>, AlgorithmType::CAPACITY_SCALING}
+    };
+
+    Graph graph;
+    if (argc > 2) {
+        std::vector<int> params;
+        for (int i = 3; i < argc; ++i) params.push_back(std::stoi(argv[i]));
+        graph = generators::generate(std::stoi(argv[2]), params);
+    } else {
+        graph.read_dimacs(std::cin);
+    }
+    FlowState flow(graph);
+
+    std::map<std::string, Measure> measures;
+    for (const auto& config : strategies) {
+        measures[config.name] = run_ford_fulkerson(graph, flow, config);
+        print(config.name, measures[config.name]);
+    }
+    measures["dinics"] = run_dinic(graph, flow);
+    print("dinics", measures["dinics"]);
+
+    std::string selected = select_strategy(compute_features(graph, graph.get_source(), graph.get_sink()));
+    print("auto=" + selected, measures[selected]);
+    return 0;
+}
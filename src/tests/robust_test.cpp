@@ -38,15 +38,16 @@ int main() {
     const int num_repetitions = 5;
 
     std::vector<StrategyConfig> strategies = {
-        {"bfs", bfs_path, AlgorithmType::BFS_EDMONDS_KARP},
-        {"dfs", dfs_path, AlgorithmType::DFS_RANDOM},
-        {"fat", fattest_path, AlgorithmType::FATTEST_PATH},
-        {"scaling", capacity_scaling_path, AlgorithmType::CAPACITY_SCALING}
+        {"bfs", bfs_path<int>, AlgorithmType::BFS_EDMONDS_KARP},
+        {"dfs", dfs_path<int>, AlgorithmType::DFS_RANDOM},
+        {"fat", fattest_path<int>, AlgorithmType::FATTEST_PATH},
+        {"scaling", capacity_scaling_path<int>, AlgorithmType::CAPACITY_SCALING}
     };
 
     // Read the input graph once
     Graph original;
     original.read_dimacs(std::cin);
+    FlowState flow(original);     // one flow overlay, reset for every run
     int source = original.get_source();
     int sink   = original.get_sink();
 
@@ -82,12 +83,12 @@ int main() {
         int   max_flow = -1;
 
         for (int rep = 0; rep < num_repetitions; ++rep) {
-            // Copy graph and reset stats
-            Graph copy = original;
+            // Reset flows in place (no graph copy) and stats
+            flow.reset();
             FFStats stats;
 
             // Run algorithm (stats.total_runtime set inside ford_fulkerson)
-            max_flow = ford_fulkerson(copy, source, sink, config.strategy, config.type, &stats);
+            max_flow = ford_fulkerson(original, flow, source, sink, config.strategy, config.type, &stats);
 
             // Accumulate
             sum_runtime                  += stats.total_runtime;
@@ -24,16 +24,16 @@ int main(int argc, char* argv[]) {
     AlgorithmType type;
 
     if (strategy_name == "bfs") {
-        strategy = bfs_path;
+        strategy = bfs_path<int>;
         type = AlgorithmType::BFS_EDMONDS_KARP;
     } else if (strategy_name == "dfs") {
-        strategy = dfs_path;
+        strategy = dfs_path<int>;
         type = AlgorithmType::DFS_RANDOM;
     } else if (strategy_name == "fat") {
-        strategy = fattest_path;
+        strategy = fattest_path<int>;
         type = AlgorithmType::FATTEST_PATH;
     } else if (strategy_name == "scaling") {
-        strategy = capacity_scaling_path;
+        strategy = capacity_scaling_path<int>;
         type = AlgorithmType::CAPACITY_SCALING;
     } else if (strategy_name == "dinics") {
         is_ford_fulkerson = false;
@@ -53,11 +53,12 @@ int main(int argc, char* argv[]) {
     int max_flow = -3;
 
     FFStats stats;
+    FlowState flow(graph);
 
     if(is_ford_fulkerson){
-        max_flow = ford_fulkerson(graph, source, sink, strategy, type, &stats);
+        max_flow = ford_fulkerson(graph, flow, source, sink, strategy, type, &stats);
     }else{ 
-        max_flow = dinic_max_flow(graph, source, sink);
+        max_flow = dinic_max_flow(graph, flow, source, sink);
     }
 
     if(is_cout_csv){
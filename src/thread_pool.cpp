@@ -0,0 +1,104 @@
+#include "thread_pool.hpp"
+#include "numa.hpp"
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace thread_pool {
+
+namespace {
+    thread_local bool is_pool_thread = false;
+
+    // Workers parked on a condition variable; each call is a new generation of work
+    class Pool {
+    public:
+        ~Pool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (auto& th : threads) {
+                th.join();
+            }
+        }
+
+        // Runs the call on the pool, or returns false if another call holds it
+        bool try_run(int workers, const std::function<void(int)>& body) {
+            std::unique_lock<std::mutex> caller(call, std::try_to_lock);
+            if (!caller.owns_lock()) return false;
+
+            std::unique_lock<std::mutex> lock(mutex);
+            while (static_cast<int>(threads.size()) < workers) {
+                int id = static_cast<int>(threads.size());
+                threads.emplace_back([this, id, seen = generation] { work(id, seen); });
+            }
+            job = &body;
+            job_workers = workers;
+            remaining = workers;
+            ++generation;
+            wake.notify_all();
+            finished.wait(lock, [&] { return remaining == 0; });
+            job = nullptr;
+            return true;
+        }
+
+    private:
+        std::mutex call;   // Held by the caller whose job is on the pool
+        std::mutex mutex;
+        std::condition_variable wake, finished;
+        std::vector<std::thread> threads;
+        const std::function<void(int)>* job = nullptr;
+        int job_workers = 0;
+        int remaining = 0;
+        unsigned long long generation = 0;
+        bool stopping = false;
+
+        void work(int id, unsigned long long seen) {
+            numa::pin_worker(id);
+            is_pool_thread = true;
+
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+                if (id >= job_workers) continue; // a smaller call, this worker sits it out
+
+                const std::function<void(int)>& body = *job;
+                lock.unlock();
+                body(id);
+                lock.lock();
+                if (--remaining == 0) finished.notify_all();
+            }
+        }
+    };
+
+    Pool& pool() {
+        static Pool instance;
+        return instance;
+    }
+} // namespace
+
+void run(int workers, const std::function<void(int)>& body) {
+    if (workers <= 1) {
+        body(0);
+        return;
+    }
+    if (!is_pool_thread && pool().try_run(workers, body)) return;
+
+    // Nested or concurrent call: short-lived threads, as the pool is taken
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+    for (int w = 0; w < workers; ++w) {
+        threads.emplace_back([&body, w] {
+            numa::pin_worker(w);
+            body(w);
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+}
+
+} // namespace thread_pool
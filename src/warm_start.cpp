@@ -0,0 +1,84 @@
+#include "warm_start.hpp"
+#include "dinics.hpp"
+#include "find_path_headers/bfs.hpp"
+#include <algorithm>
+
+// Pushes up to `limit` units along a residual path, returns how much was pushed
+template <typename Cap>
+static Cap push_along(const BasicGraph<Cap>& graph, BasicFlowState<Cap>& flow, const Path& path, Cap limit) {
+    using Edge = BasicEdge<Cap>;
+    Cap amount = limit;
+    for (const auto& [u, idx] : path) {
+        amount = std::min(amount, flow.remaining_capacity(graph.adj(u)[idx]));
+    }
+
+    for (const auto& [u, idx] : path) {
+        const Edge& e = graph.adj(u)[idx];
+        flow.augment(e, graph.adj(e.to)[e.rev], amount);
+    }
+
+    return amount;
+}
+
+// Sends up to `amount` units from `from` to `to` through the residual graph.
+// Returns how much could not be sent.
+template <typename Cap>
+static Cap drain(const BasicGraph<Cap>& graph, BasicFlowState<Cap>& flow, int from, int to, Cap amount) {
+    Path path;
+    FFStats scratch; // bfs_path records search stats, which are irrelevant here
+
+    while (amount > 0 && from != to && bfs_path(graph, flow, from, to, path, &scratch)) {
+        amount -= push_along(graph, flow, path, amount);
+    }
+
+    return (from == to) ? 0 : amount;
+}
+
+template <typename Cap>
+Cap repair_flow(BasicGraph<Cap>& graph, BasicFlowState<Cap>& flow, int s, int t) {
+    using Edge = BasicEdge<Cap>;
+    flow.fit(graph);
+
+    for (const auto& [u, v] : graph.lowered_arcs()) {
+        int idx = graph.find_arc(u, v);
+        if (idx == -1) continue;
+
+        const Edge& e = graph.adj(u)[idx];
+        Cap excess = -flow.remaining_capacity(e);
+        if (excess <= 0) continue; // still feasible
+
+        // Cut the flow down to the new capacity: u now has `excess` too much
+        // inflow and v has `excess` too little.
+        flow.augment(e, graph.adj(e.to)[e.rev], -excess);
+
+        // Reroute around the arc first, this keeps the flow value
+        Cap left = drain(graph, flow, u, v, excess);
+
+        // Otherwise give the surplus back to s and pull the deficit back from t
+        drain(graph, flow, u, s, left);
+        drain(graph, flow, t, v, left);
+    }
+
+    graph.clear_lowered_arcs();
+    graph.purge_removed_arcs(flow);
+    return flow.flow_value(graph, s);
+}
+
+template <typename Cap>
+Cap warm_ford_fulkerson(BasicGraph<Cap>& graph, BasicFlowState<Cap>& flow, int s, int t, BasicPathFindingStrategy<Cap> find_path, AlgorithmType type, FFStats* stats) {
+    Cap current = repair_flow(graph, flow, s, t);
+    return current + ford_fulkerson(graph, flow, s, t, find_path, type, stats);
+}
+
+template <typename Cap>
+Cap warm_dinic_max_flow(BasicGraph<Cap>& graph, BasicFlowState<Cap>& flow, int s, int t) {
+    Cap current = repair_flow(graph, flow, s, t);
+    return current + dinic_max_flow(graph, flow, s, t);
+}
+
+template int repair_flow(Graph&, FlowState&, int, int);
+template long long repair_flow(Graph64&, FlowState64&, int, int);
+template int warm_ford_fulkerson(Graph&, FlowState&, int, int, PathFindingStrategy, AlgorithmType, FFStats*);
+template long long warm_ford_fulkerson(Graph64&, FlowState64&, int, int, BasicPathFindingStrategy<long long>, AlgorithmType, FFStats*);
+template int warm_dinic_max_flow(Graph&, FlowState&, int, int);
+template long long warm_dinic_max_flow(Graph64&, FlowState64&, int, int);